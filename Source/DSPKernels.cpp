@@ -0,0 +1,130 @@
+#include "DSPKernels.h"
+#include <juce_core/juce_core.h>
+
+#if JUCESYNTH_X86_KERNELS
+ #if defined(_MSC_VER)
+  #include <intrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+#endif
+
+static const DSPKernels* getCompiledKernels(InstructionSet set)
+{
+    switch (set)
+    {
+        case InstructionSet::SSE2:   return getSSE2Kernels();
+        case InstructionSet::AVX2:   return getAVX2Kernels();
+        case InstructionSet::AVX512: return getAVX512Kernels();
+        case InstructionSet::Scalar:
+        default:                     return getScalarKernels();
+    }
+}
+
+// XCR0 bits 1-2 (SSE and AVX state) and 5-7 (opmask, upper ZMM0-15, ZMM16-31)
+static constexpr unsigned long long ymmStateBits = 0x06;
+static constexpr unsigned long long zmmStateBits = 0xe0;
+
+// SystemStats only reports the CPUID feature bits. The OS must also have enabled the
+// wider register state in XCR0, which VMs and some kernels leave off for YMM/ZMM.
+static bool isRegisterStateEnabled(unsigned long long requiredBits)
+{
+   #if JUCESYNTH_X86_KERNELS
+    unsigned int ecx = 0;
+
+   #if defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 1);
+    ecx = static_cast<unsigned int>(info[2]);
+   #else
+    unsigned int eax = 0, ebx = 0, edx = 0;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+   #endif
+
+    // XGETBV is only available once the OS has set OSXSAVE
+    if ((ecx & (1u << 27)) == 0)
+        return false;
+
+   #if defined(_MSC_VER)
+    const unsigned long long xcr0 = _xgetbv(0);
+   #else
+    unsigned int xcr0Low = 0, xcr0High = 0;
+    __asm__ volatile ("xgetbv" : "=a" (xcr0Low), "=d" (xcr0High) : "c" (0));
+    const unsigned long long xcr0 = (static_cast<unsigned long long>(xcr0High) << 32) | xcr0Low;
+   #endif
+
+    return (xcr0 & requiredBits) == requiredBits;
+   #else
+    juce::ignoreUnused(requiredBits);
+    return false;
+   #endif
+}
+
+bool DSPKernels::isSupported(InstructionSet set)
+{
+    if (getCompiledKernels(set) == nullptr)
+        return false;
+
+    switch (set)
+    {
+        case InstructionSet::SSE2:   return juce::SystemStats::hasSSE2();
+        case InstructionSet::AVX2:   return juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3()
+                                         && isRegisterStateEnabled(ymmStateBits);
+        case InstructionSet::AVX512: return juce::SystemStats::hasAVX512F()
+                                         && isRegisterStateEnabled(ymmStateBits | zmmStateBits);
+        case InstructionSet::Scalar:
+        default:                     return true;
+    }
+}
+
+InstructionSet DSPKernels::detectBest()
+{
+    for (auto set : { InstructionSet::AVX512, InstructionSet::AVX2, InstructionSet::SSE2 })
+        if (isSupported(set))
+            return set;
+
+    return InstructionSet::Scalar;
+}
+
+bool DSPKernels::parseName(const char* name, InstructionSet& result)
+{
+    const auto text = juce::String(name).trim().toLowerCase().removeCharacters("-_");
+
+    if (text == "scalar")      result = InstructionSet::Scalar;
+    else if (text == "sse2")   result = InstructionSet::SSE2;
+    else if (text == "avx2")   result = InstructionSet::AVX2;
+    else if (text == "avx512") result = InstructionSet::AVX512;
+    else                       return false;
+
+    return true;
+}
+
+const DSPKernels& DSPKernels::get(InstructionSet set)
+{
+    if (!isSupported(set))
+        set = detectBest();
+
+    return *getCompiledKernels(set);
+}
+
+const DSPKernels& DSPKernels::select(const char* forcedName)
+{
+    if (forcedName != nullptr && *forcedName != 0)
+    {
+        InstructionSet forced;
+
+        if (parseName(forcedName, forced))
+        {
+            if (!isSupported(forced))
+                DBG("Forced instruction set '" << forcedName << "' isn't supported here, using CPU detection");
+
+            return get(forced);
+        }
+
+        DBG("Unknown instruction set '" << forcedName << "', using CPU detection");
+    }
+
+    return get(detectBest());
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+// Block-processing kernels used by SynthVoice (oscillator fill, envelope and
+// mix-to-output) and by FilterBank, which filters all voices at once. The same
+// algorithms in DSPKernelsImpl.h are compiled once per instruction set
+// (DSPKernelsScalar.cpp, DSPKernelsSSE2.cpp, DSPKernelsAVX2.cpp, DSPKernelsAVX512.cpp)
+// and the best variant for the host CPU is picked once in prepareToPlay.
+//
+// This header is included by the ISA-specific translation units, so it must not pull
+// in JUCE or other headers with inline code: those functions would be compiled with
+// AVX flags and the linker could pick that copy for code running on older CPUs.
+
+enum class InstructionSet
+{
+    Scalar = 0,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+struct DSPKernels
+{
+    // Fills dest with one of SynthVoice's computed waveforms (Sine, Saw, Square or
+    // Triangle). phase is normalised to [0, 1) and is advanced by increment per sample.
+    using FillOscillatorFn = void (*)(float* dest, int numSamples, double& phase, double increment, int waveform);
+
+    // base = baseCutoff + i * baseCutoffStep
+    // cutoff[i] = jlimit(20, 20000, base + lfo[i] * depth * base * 0.5)
+    using ModulateCutoffFn = void (*)(float* cutoff, const float* lfo, float baseCutoff, float baseCutoffStep,
+                                      float depth, int numSamples);
+
+    // Converts cutoff frequencies in place to the TPT coefficient tan(pi * fc / fs).
+    // A new value is only computed when the cutoff changes, and at most every
+    // coefficientInterval samples; in between the previous coefficient is held.
+    using FilterCoefficientsFn = void (*)(float* values, int numSamples, float sampleRate, int coefficientInterval);
+
+    // Runs the active lanes among the first numLanes of an interleaved filter bank (see
+    // FilterBank), one vector of lanes at a time. samples and coefficients are laid out
+    // [sample][lane] with laneStride floats per row, resonance has one value per lane,
+    // and state holds filterStateRows rows of laneStride floats. numLanes must be a
+    // multiple of maxVectorWidth. mode is a FilterBank::Mode.
+    using FilterBankFn = void (*)(float* samples, const float* coefficients, const float* resonance, float* state,
+                                  const bool* laneActive, int numLanes, int laneStride, int numSamples, int mode);
+
+    // samples[i] *= envelope[i] * level
+    using ApplyEnvelopeFn = void (*)(float* samples, const float* envelope, float level, int numSamples);
+
+    // dest[i] += source[i]
+    using MixToOutputFn = void (*)(float* dest, const float* source, int numSamples);
+
+    // SVF integrators use the first two rows, the ladder all five
+    static constexpr int filterStateRows = 5;
+
+    // Lane counts must be a multiple of this so every variant works in whole vectors
+    static constexpr int maxVectorWidth = 16;
+
+    InstructionSet instructionSet;
+    const char* name;
+    int vectorWidth; // lanes per vector, processFilterBank works in groups of this many
+
+    FillOscillatorFn fillOscillator;
+    ModulateCutoffFn modulateCutoff;
+    FilterCoefficientsFn computeFilterCoefficients;
+    FilterBankFn processFilterBank;
+    ApplyEnvelopeFn applyEnvelope;
+    MixToOutputFn mixToOutput;
+
+    // True if this build contains the variant and the CPU can run it.
+    static bool isSupported(InstructionSet set);
+
+    // The widest supported instruction set on this machine.
+    static InstructionSet detectBest();
+
+    // Parses "scalar", "sse2", "avx2" or "avx512" (case-insensitive). Returns false for
+    // anything else, leaving result untouched.
+    static bool parseName(const char* name, InstructionSet& result);
+
+    // Returns the kernels for the requested set, or for the best supported one if the
+    // request can't run here.
+    static const DSPKernels& get(InstructionSet set);
+
+    // Picks the kernels to use for rendering. A non-empty forcedName (see parseName)
+    // overrides CPU detection, which is useful for benchmarking the variants against
+    // each other on one machine.
+    static const DSPKernels& select(const char* forcedName = nullptr);
+};
+
+// Per-ISA tables, defined in the matching DSPKernels*.cpp file. The x86 variants
+// return nullptr when the build doesn't include them.
+const DSPKernels* getScalarKernels();
+const DSPKernels* getSSE2Kernels();
+const DSPKernels* getAVX2Kernels();
+const DSPKernels* getAVX512Kernels();
@@ -0,0 +1,49 @@
+#include "DSPKernelsImpl.h"
+
+// 8-lane variant. Compiled with -mavx2 -mfma (or /arch:AVX2), see CMakeLists.txt.
+
+#if JUCESYNTH_X86_KERNELS
+
+#include <immintrin.h>
+
+namespace
+{
+struct AVX2Ops
+{
+    using Vec = __m256;
+    using Mask = __m256;
+    static constexpr int width = 8;
+
+    static Vec load(const float* p)                 { return _mm256_loadu_ps(p); }
+    static void store(float* p, Vec v)              { _mm256_storeu_ps(p, v); }
+    static Vec set1(float x)                        { return _mm256_set1_ps(x); }
+    static Vec laneIndex()                          { return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); }
+    static Vec add(Vec a, Vec b)                    { return _mm256_add_ps(a, b); }
+    static Vec sub(Vec a, Vec b)                    { return _mm256_sub_ps(a, b); }
+    static Vec mul(Vec a, Vec b)                    { return _mm256_mul_ps(a, b); }
+    static Vec div(Vec a, Vec b)                    { return _mm256_div_ps(a, b); }
+    static Vec mulAdd(Vec a, Vec b, Vec c)          { return _mm256_fmadd_ps(a, b, c); }
+    static Vec min(Vec a, Vec b)                    { return _mm256_min_ps(a, b); }
+    static Vec max(Vec a, Vec b)                    { return _mm256_max_ps(a, b); }
+    static Vec floor(Vec a)                         { return _mm256_floor_ps(a); }
+    static Mask lessThan(Vec a, Vec b)              { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static Mask greaterThan(Vec a, Vec b)           { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Vec select(Mask m, Vec a, Vec b)         { return _mm256_blendv_ps(b, a, m); }
+};
+
+constexpr DSPKernels avx2Kernels = DSPKernelsImpl::makeKernels<AVX2Ops>(InstructionSet::AVX2, "AVX2");
+} // namespace
+
+const DSPKernels* getAVX2Kernels()
+{
+    return &avx2Kernels;
+}
+
+#else
+
+const DSPKernels* getAVX2Kernels()
+{
+    return nullptr;
+}
+
+#endif
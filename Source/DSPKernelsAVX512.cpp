@@ -0,0 +1,61 @@
+#include "DSPKernelsImpl.h"
+
+// 16-lane variant, AVX-512F only. Compiled with -mavx512f (or /arch:AVX512), see
+// CMakeLists.txt.
+
+#if JUCESYNTH_X86_KERNELS
+
+#include <immintrin.h>
+
+// GCC 12's own _mm512_undefined_ps() self-initialises and trips -Wmaybe-uninitialized
+// wherever min/max get inlined (GCC bug 105593, fixed in 12.3)
+#if defined(__GNUC__) && !defined(__clang__)
+ #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace
+{
+struct AVX512Ops
+{
+    using Vec = __m512;
+    using Mask = __mmask16;
+    static constexpr int width = 16;
+
+    static Vec load(const float* p)                 { return _mm512_loadu_ps(p); }
+    static void store(float* p, Vec v)              { _mm512_storeu_ps(p, v); }
+    static Vec set1(float x)                        { return _mm512_set1_ps(x); }
+    static Vec add(Vec a, Vec b)                    { return _mm512_add_ps(a, b); }
+    static Vec sub(Vec a, Vec b)                    { return _mm512_sub_ps(a, b); }
+    static Vec mul(Vec a, Vec b)                    { return _mm512_mul_ps(a, b); }
+    static Vec div(Vec a, Vec b)                    { return _mm512_div_ps(a, b); }
+    static Vec mulAdd(Vec a, Vec b, Vec c)          { return _mm512_fmadd_ps(a, b, c); }
+    static Vec min(Vec a, Vec b)                    { return _mm512_min_ps(a, b); }
+    static Vec max(Vec a, Vec b)                    { return _mm512_max_ps(a, b); }
+    static Vec floor(Vec a)                         { return _mm512_floor_ps(a); }
+    static Mask lessThan(Vec a, Vec b)              { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static Mask greaterThan(Vec a, Vec b)           { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static Vec select(Mask m, Vec a, Vec b)         { return _mm512_mask_blend_ps(m, b, a); }
+
+    static Vec laneIndex()
+    {
+        return _mm512_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                              8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f);
+    }
+};
+
+constexpr DSPKernels avx512Kernels = DSPKernelsImpl::makeKernels<AVX512Ops>(InstructionSet::AVX512, "AVX-512");
+} // namespace
+
+const DSPKernels* getAVX512Kernels()
+{
+    return &avx512Kernels;
+}
+
+#else
+
+const DSPKernels* getAVX512Kernels()
+{
+    return nullptr;
+}
+
+#endif
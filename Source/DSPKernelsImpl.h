@@ -0,0 +1,363 @@
+#pragma once
+
+#include "DSPKernels.h"
+#include <math.h>
+#include <stddef.h>
+
+// Shared kernel algorithms, written once against a small "Ops" abstraction and
+// instantiated by each DSPKernels*.cpp file with its own vector type:
+//
+//     using Vec / Mask;  static constexpr int width;
+//     load, store, set1, laneIndex, add, sub, mul, div, mulAdd (a * b + c),
+//     min, max, floor, lessThan, greaterThan, select (mask ? a : b)
+//
+// Everything here is a template on Ops, and every Ops type lives in an anonymous
+// namespace, so each ISA gets its own symbols. Only extern C maths functions are used
+// for the same reason (see the note in DSPKernels.h).
+
+namespace DSPKernelsImpl
+{
+
+template <typename Ops>
+double wrapPhase(double phase)
+{
+    return phase - ::floor(phase);
+}
+
+template <typename Ops>
+typename Ops::Vec wrap(typename Ops::Vec p)
+{
+    return Ops::sub(p, Ops::floor(p));
+}
+
+//==============================================================================
+// Waveform shapes, all taking a normalised phase in [0, 1).
+
+struct SineShape
+{
+    template <typename Ops>
+    static typename Ops::Vec process(typename Ops::Vec p)
+    {
+        // sin(2 pi p) = -sin(2 pi (p - 0.5)); fold into [-1/4, 1/4] so the Taylor
+        // series below stays accurate to ~1e-7.
+        auto x = Ops::sub(p, Ops::set1(0.5f));
+        x = Ops::select(Ops::greaterThan(x, Ops::set1(0.25f)), Ops::sub(Ops::set1(0.5f), x), x);
+        x = Ops::select(Ops::lessThan(x, Ops::set1(-0.25f)), Ops::sub(Ops::set1(-0.5f), x), x);
+
+        const auto y = Ops::mul(x, Ops::set1(6.28318530717958647692f));
+        const auto y2 = Ops::mul(y, y);
+
+        auto poly = Ops::set1(-1.0f / 39916800.0f);
+        poly = Ops::mulAdd(poly, y2, Ops::set1(1.0f / 362880.0f));
+        poly = Ops::mulAdd(poly, y2, Ops::set1(-1.0f / 5040.0f));
+        poly = Ops::mulAdd(poly, y2, Ops::set1(1.0f / 120.0f));
+        poly = Ops::mulAdd(poly, y2, Ops::set1(-1.0f / 6.0f));
+        poly = Ops::mulAdd(poly, y2, Ops::set1(1.0f));
+
+        return Ops::mul(Ops::mul(poly, y), Ops::set1(-1.0f));
+    }
+};
+
+struct SawShape
+{
+    template <typename Ops>
+    static typename Ops::Vec process(typename Ops::Vec p)
+    {
+        return Ops::mulAdd(p, Ops::set1(2.0f), Ops::set1(-1.0f));
+    }
+};
+
+struct SquareShape
+{
+    template <typename Ops>
+    static typename Ops::Vec process(typename Ops::Vec p)
+    {
+        return Ops::select(Ops::lessThan(p, Ops::set1(0.5f)), Ops::set1(1.0f), Ops::set1(-1.0f));
+    }
+};
+
+struct TriangleShape
+{
+    template <typename Ops>
+    static typename Ops::Vec process(typename Ops::Vec p)
+    {
+        return Ops::select(Ops::lessThan(p, Ops::set1(0.5f)),
+                           Ops::mulAdd(p, Ops::set1(4.0f), Ops::set1(-1.0f)),
+                           Ops::mulAdd(p, Ops::set1(-4.0f), Ops::set1(3.0f)));
+    }
+};
+
+//==============================================================================
+template <typename Ops, typename Shape>
+void fillWaveform(float* dest, int numSamples, double& phase, double increment)
+{
+    constexpr int width = Ops::width;
+
+    // Lanes are computed from a per-vector base phase, which keeps the accumulated
+    // phase in double precision while the lane offsets stay small enough for floats.
+    const auto offsets = Ops::mul(Ops::laneIndex(), Ops::set1(static_cast<float>(increment)));
+    const double vectorIncrement = increment * width;
+
+    int i = 0;
+
+    for (; i + width <= numSamples; i += width)
+    {
+        const auto p = wrap<Ops>(Ops::add(Ops::set1(static_cast<float>(phase)), offsets));
+        Ops::store(dest + i, Shape::template process<Ops>(p));
+        phase = wrapPhase<Ops>(phase + vectorIncrement);
+    }
+
+    if (i < numSamples)
+    {
+        float tail[static_cast<size_t>(width)];
+        const auto p = wrap<Ops>(Ops::add(Ops::set1(static_cast<float>(phase)), offsets));
+        Ops::store(tail, Shape::template process<Ops>(p));
+
+        const int remaining = numSamples - i;
+
+        for (int j = 0; j < remaining; ++j)
+            dest[i + j] = tail[j];
+
+        phase = wrapPhase<Ops>(phase + increment * remaining);
+    }
+}
+
+template <typename Ops>
+void fillOscillator(float* dest, int numSamples, double& phase, double increment, int waveform)
+{
+    // Values match SynthVoice::WaveformType
+    switch (waveform)
+    {
+        case 1:  fillWaveform<Ops, SawShape>(dest, numSamples, phase, increment); break;
+        case 2:  fillWaveform<Ops, SquareShape>(dest, numSamples, phase, increment); break;
+        case 3:  fillWaveform<Ops, TriangleShape>(dest, numSamples, phase, increment); break;
+        default: fillWaveform<Ops, SineShape>(dest, numSamples, phase, increment); break;
+    }
+}
+
+template <typename Ops>
+void modulateCutoff(float* cutoff, const float* lfo, float baseCutoff, float baseCutoffStep,
+                    float depth, int numSamples)
+{
+    constexpr int width = Ops::width;
+    const float halfDepth = depth * 0.5f;
+
+    const auto lanes = Ops::laneIndex();
+    const auto base = Ops::set1(baseCutoff);
+    const auto step = Ops::set1(baseCutoffStep);
+    const auto halfDepthVec = Ops::set1(halfDepth);
+    const auto lower = Ops::set1(20.0f);
+    const auto upper = Ops::set1(20000.0f);
+
+    int i = 0;
+
+    for (; i + width <= numSamples; i += width)
+    {
+        const auto rampedBase = Ops::mulAdd(Ops::add(Ops::set1(static_cast<float>(i)), lanes), step, base);
+        const auto modulated = Ops::mulAdd(Ops::mul(Ops::load(lfo + i), halfDepthVec), rampedBase, rampedBase);
+        Ops::store(cutoff + i, Ops::min(Ops::max(modulated, lower), upper));
+    }
+
+    for (; i < numSamples; ++i)
+    {
+        const float rampedBase = baseCutoff + static_cast<float>(i) * baseCutoffStep;
+        const float modulated = lfo[i] * halfDepth * rampedBase + rampedBase;
+        cutoff[i] = modulated < 20.0f ? 20.0f : (modulated > 20000.0f ? 20000.0f : modulated);
+    }
+}
+
+template <typename Ops>
+void computeFilterCoefficients(float* values, int numSamples, float sampleRate, int coefficientInterval)
+{
+    // tan() has no cheap vector form over the full cutoff range, so this stays scalar;
+    // skipping unchanged cutoffs avoids it entirely without LFO modulation.
+    const double piOverSampleRate = 3.14159265358979323846 / sampleRate;
+
+    float lastCutoff = -1.0f;
+    float g = 0.0f;
+    int samplesUntilUpdate = 0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (--samplesUntilUpdate <= 0 && (values[i] < lastCutoff || values[i] > lastCutoff))
+        {
+            samplesUntilUpdate = coefficientInterval;
+            lastCutoff = values[i];
+            g = static_cast<float>(::tan(piOverSampleRate * lastCutoff));
+        }
+
+        values[i] = g;
+    }
+}
+
+//==============================================================================
+// Filter bank. Each call advances one vector of voices (lanes) through the whole
+// block, so the serial dependency is only along time and never inside a vector.
+
+template <typename Ops>
+typename Ops::Vec tanhApprox(typename Ops::Vec x)
+{
+    // Pade approximant, exact at +-3 where it's clamped
+    x = Ops::min(Ops::max(x, Ops::set1(-3.0f)), Ops::set1(3.0f));
+    const auto x2 = Ops::mul(x, x);
+    return Ops::div(Ops::mul(x, Ops::add(x2, Ops::set1(27.0f))), Ops::mulAdd(x2, Ops::set1(9.0f), Ops::set1(27.0f)));
+}
+
+struct LowpassOutput  { template <typename Ops, typename V> static V get(V lp, V, V)     { return lp; } };
+struct BandpassOutput { template <typename Ops, typename V> static V get(V, V bp, V)     { return bp; } };
+struct HighpassOutput { template <typename Ops, typename V> static V get(V, V, V hp)     { return hp; } };
+struct NotchOutput    { template <typename Ops, typename V> static V get(V lp, V, V hp)  { return Ops::add(lp, hp); } };
+
+template <typename Ops, typename Output>
+void processSVFLanes(float* samples, const float* coefficients, const float* resonance, float* state,
+                     int laneStride, int numSamples)
+{
+    // Same TPT structure as juce::dsp::StateVariableTPTFilter
+    const auto one = Ops::set1(1.0f);
+    const auto R2 = Ops::div(one, Ops::load(resonance));
+
+    auto s1 = Ops::load(state);
+    auto s2 = Ops::load(state + laneStride);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float* x = samples + i * laneStride;
+        const auto g = Ops::load(coefficients + i * laneStride);
+        const auto h = Ops::div(one, Ops::mulAdd(g, Ops::add(g, R2), one));
+
+        const auto yHP = Ops::mul(h, Ops::sub(Ops::sub(Ops::load(x), Ops::mul(s1, Ops::add(g, R2))), s2));
+        const auto yBP = Ops::mulAdd(yHP, g, s1);
+        s1 = Ops::mulAdd(yHP, g, yBP);
+
+        const auto yLP = Ops::mulAdd(yBP, g, s2);
+        s2 = Ops::mulAdd(yBP, g, yLP);
+
+        Ops::store(x, Output::template get<Ops>(yLP, yBP, yHP));
+    }
+
+    Ops::store(state, s1);
+    Ops::store(state + laneStride, s2);
+}
+
+template <typename Ops>
+void processLadderLanes(float* samples, const float* coefficients, const float* resonance, float* state,
+                        int laneStride, int numSamples)
+{
+    // Four TPT one-pole stages with tanh saturation between them and a unit-delayed
+    // feedback path. Resonance 0.1..2 maps to a feedback gain of 0..3.8, and the input
+    // is partly boosted to make up for the passband loss at high resonance.
+    const auto zero = Ops::set1(0.0f);
+    const auto one = Ops::set1(1.0f);
+    const auto k = Ops::min(Ops::max(Ops::mul(Ops::sub(Ops::load(resonance), Ops::set1(0.1f)), Ops::set1(2.0f)), zero),
+                            Ops::set1(3.8f));
+    const auto inputGain = Ops::mulAdd(k, Ops::set1(0.5f), one);
+
+    typename Ops::Vec s[4];
+
+    for (int stage = 0; stage < 4; ++stage)
+        s[stage] = Ops::load(state + stage * laneStride);
+
+    auto feedback = Ops::load(state + 4 * laneStride);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float* x = samples + i * laneStride;
+        const auto g = Ops::load(coefficients + i * laneStride);
+        const auto G = Ops::div(g, Ops::add(one, g));
+
+        auto u = tanhApprox<Ops>(Ops::sub(Ops::mul(Ops::load(x), inputGain), Ops::mul(k, feedback)));
+
+        for (int stage = 0; stage < 4; ++stage)
+        {
+            const auto v = Ops::mul(Ops::sub(u, s[stage]), G);
+            const auto y = Ops::add(v, s[stage]);
+            s[stage] = Ops::add(y, v);
+            u = stage < 3 ? tanhApprox<Ops>(y) : y;
+        }
+
+        feedback = u;
+        Ops::store(x, u);
+    }
+
+    for (int stage = 0; stage < 4; ++stage)
+        Ops::store(state + stage * laneStride, s[stage]);
+
+    Ops::store(state + 4 * laneStride, feedback);
+}
+
+template <typename Ops>
+void processFilterBank(float* samples, const float* coefficients, const float* resonance, float* state,
+                       const bool* laneActive, int numLanes, int laneStride, int numSamples, int mode)
+{
+    constexpr int width = Ops::width;
+
+    for (int lane = 0; lane < numLanes; lane += width)
+    {
+        bool anyActive = false;
+
+        for (int j = 0; j < width; ++j)
+            anyActive = anyActive || laneActive[lane + j];
+
+        if (!anyActive)
+            continue;
+
+        float* laneSamples = samples + lane;
+        const float* laneCoefficients = coefficients + lane;
+        const float* laneResonance = resonance + lane;
+        float* laneState = state + lane;
+
+        // Values match FilterBank::Mode
+        switch (mode)
+        {
+            case 1:  processSVFLanes<Ops, BandpassOutput>(laneSamples, laneCoefficients, laneResonance, laneState, laneStride, numSamples); break;
+            case 2:  processSVFLanes<Ops, HighpassOutput>(laneSamples, laneCoefficients, laneResonance, laneState, laneStride, numSamples); break;
+            case 3:  processSVFLanes<Ops, NotchOutput>(laneSamples, laneCoefficients, laneResonance, laneState, laneStride, numSamples); break;
+            case 4:  processLadderLanes<Ops>(laneSamples, laneCoefficients, laneResonance, laneState, laneStride, numSamples); break;
+            default: processSVFLanes<Ops, LowpassOutput>(laneSamples, laneCoefficients, laneResonance, laneState, laneStride, numSamples); break;
+        }
+    }
+}
+
+template <typename Ops>
+void applyEnvelope(float* samples, const float* envelope, float level, int numSamples)
+{
+    constexpr int width = Ops::width;
+    const auto levelVec = Ops::set1(level);
+
+    int i = 0;
+
+    for (; i + width <= numSamples; i += width)
+        Ops::store(samples + i, Ops::mul(Ops::load(samples + i), Ops::mul(Ops::load(envelope + i), levelVec)));
+
+    for (; i < numSamples; ++i)
+        samples[i] *= envelope[i] * level;
+}
+
+template <typename Ops>
+void mixToOutput(float* dest, const float* source, int numSamples)
+{
+    constexpr int width = Ops::width;
+
+    int i = 0;
+
+    for (; i + width <= numSamples; i += width)
+        Ops::store(dest + i, Ops::add(Ops::load(dest + i), Ops::load(source + i)));
+
+    for (; i < numSamples; ++i)
+        dest[i] += source[i];
+}
+
+//==============================================================================
+template <typename Ops>
+constexpr DSPKernels makeKernels(InstructionSet set, const char* name)
+{
+    return { set, name, Ops::width,
+             fillOscillator<Ops>,
+             modulateCutoff<Ops>,
+             computeFilterCoefficients<Ops>,
+             processFilterBank<Ops>,
+             applyEnvelope<Ops>,
+             mixToOutput<Ops> };
+}
+
+} // namespace DSPKernelsImpl
@@ -0,0 +1,55 @@
+#include "DSPKernelsImpl.h"
+
+// 4-lane variant. Compiled with -msse2 where the compiler needs it (see CMakeLists.txt).
+
+#if JUCESYNTH_X86_KERNELS
+
+#include <emmintrin.h>
+
+namespace
+{
+struct SSE2Ops
+{
+    using Vec = __m128;
+    using Mask = __m128;
+    static constexpr int width = 4;
+
+    static Vec load(const float* p)                 { return _mm_loadu_ps(p); }
+    static void store(float* p, Vec v)              { _mm_storeu_ps(p, v); }
+    static Vec set1(float x)                        { return _mm_set1_ps(x); }
+    static Vec laneIndex()                          { return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); }
+    static Vec add(Vec a, Vec b)                    { return _mm_add_ps(a, b); }
+    static Vec sub(Vec a, Vec b)                    { return _mm_sub_ps(a, b); }
+    static Vec mul(Vec a, Vec b)                    { return _mm_mul_ps(a, b); }
+    static Vec div(Vec a, Vec b)                    { return _mm_div_ps(a, b); }
+    static Vec mulAdd(Vec a, Vec b, Vec c)          { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static Vec min(Vec a, Vec b)                    { return _mm_min_ps(a, b); }
+    static Vec max(Vec a, Vec b)                    { return _mm_max_ps(a, b); }
+    static Mask lessThan(Vec a, Vec b)              { return _mm_cmplt_ps(a, b); }
+    static Mask greaterThan(Vec a, Vec b)           { return _mm_cmpgt_ps(a, b); }
+    static Vec select(Mask m, Vec a, Vec b)         { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+
+    static Vec floor(Vec a)
+    {
+        // No roundps before SSE4.1: truncate, then step down where that rounded up.
+        const auto truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a), _mm_set1_ps(1.0f)));
+    }
+};
+
+constexpr DSPKernels sse2Kernels = DSPKernelsImpl::makeKernels<SSE2Ops>(InstructionSet::SSE2, "SSE2");
+} // namespace
+
+const DSPKernels* getSSE2Kernels()
+{
+    return &sse2Kernels;
+}
+
+#else
+
+const DSPKernels* getSSE2Kernels()
+{
+    return nullptr;
+}
+
+#endif
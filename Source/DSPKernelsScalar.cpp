@@ -0,0 +1,37 @@
+#include "DSPKernelsImpl.h"
+
+// Portable fallback, compiled with the project's baseline flags. Also the only
+// variant available on non-x86 builds.
+
+namespace
+{
+struct ScalarOps
+{
+    using Vec = float;
+    using Mask = bool;
+    static constexpr int width = 1;
+
+    static Vec load(const float* p)                 { return *p; }
+    static void store(float* p, Vec v)              { *p = v; }
+    static Vec set1(float x)                        { return x; }
+    static Vec laneIndex()                          { return 0.0f; }
+    static Vec add(Vec a, Vec b)                    { return a + b; }
+    static Vec sub(Vec a, Vec b)                    { return a - b; }
+    static Vec mul(Vec a, Vec b)                    { return a * b; }
+    static Vec div(Vec a, Vec b)                    { return a / b; }
+    static Vec mulAdd(Vec a, Vec b, Vec c)          { return a * b + c; }
+    static Vec min(Vec a, Vec b)                    { return a < b ? a : b; }
+    static Vec max(Vec a, Vec b)                    { return a > b ? a : b; }
+    static Vec floor(Vec a)                         { return ::floorf(a); }
+    static Mask lessThan(Vec a, Vec b)              { return a < b; }
+    static Mask greaterThan(Vec a, Vec b)           { return a > b; }
+    static Vec select(Mask m, Vec a, Vec b)         { return m ? a : b; }
+};
+
+constexpr DSPKernels scalarKernels = DSPKernelsImpl::makeKernels<ScalarOps>(InstructionSet::Scalar, "Scalar");
+} // namespace
+
+const DSPKernels* getScalarKernels()
+{
+    return &scalarKernels;
+}
@@ -0,0 +1,137 @@
+#include "FilterBank.h"
+
+// HeapBlock only guarantees malloc alignment, but lane groups and staging rows are
+// laid out in whole cache lines, so they must start on one
+static float* allocateCacheAligned(juce::HeapBlock<float>& storage, size_t numFloats)
+{
+    storage.allocate(numFloats + FilterBank::lanesPerGroup, true);
+    return juce::snapPointerToAlignment(storage.get(), sizeof(float) * FilterBank::lanesPerGroup);
+}
+
+void FilterBank::prepare(int numVoices, int maxBlockSize)
+{
+    numLanes = numVoices;
+    laneStride = (numVoices + DSPKernels::maxVectorWidth - 1) / DSPKernels::maxVectorWidth * DSPKernels::maxVectorWidth;
+    blockSize = maxBlockSize;
+    stagingStride = (maxBlockSize + lanesPerGroup - 1) / lanesPerGroup * lanesPerGroup;
+    
+    const auto stagingSize = static_cast<size_t>(numLanes) * static_cast<size_t>(stagingStride);
+    inputStaging = allocateCacheAligned(inputStagingStorage, stagingSize);
+    coefficientStaging = allocateCacheAligned(coefficientStagingStorage, stagingSize);
+    
+    const auto rowsSize = static_cast<size_t>(laneStride) * static_cast<size_t>(blockSize);
+    samples = allocateCacheAligned(samplesStorage, rowsSize);
+    coefficients = allocateCacheAligned(coefficientsStorage, rowsSize);
+    resonance.allocate(static_cast<size_t>(laneStride), false);
+    state = allocateCacheAligned(stateStorage, static_cast<size_t>(laneStride * DSPKernels::filterStateRows));
+    laneActive.allocate(static_cast<size_t>(laneStride), true);
+    mixBuffer.allocate(static_cast<size_t>(blockSize), true);
+    
+    for (int lane = 0; lane < laneStride; ++lane)
+        resonance[lane] = 1.0f;
+}
+
+void FilterBank::setMode(Mode newMode)
+{
+    if (newMode == mode)
+        return;
+    
+    // The SVF modes share their integrators, so only a switch to or from the ladder,
+    // which reads the state rows differently, needs a reset
+    const bool ladderChanged = (newMode == Ladder) != (mode == Ladder);
+    mode = newMode;
+    
+    if (ladderChanged)
+        juce::FloatVectorOperations::clear(state, laneStride * DSPKernels::filterStateRows);
+}
+
+void FilterBank::resetLane(int lane)
+{
+    for (int row = 0; row < DSPKernels::filterStateRows; ++row)
+        state[row * laneStride + lane] = 0.0f;
+}
+
+void FilterBank::writeLane(int lane, const float* input, const float* laneCoefficients, float laneResonance, int numSamples)
+{
+    jassert(numSamples <= blockSize);
+    
+    juce::FloatVectorOperations::copy(inputStaging + lane * stagingStride, input, numSamples);
+    juce::FloatVectorOperations::copy(coefficientStaging + lane * stagingStride, laneCoefficients, numSamples);
+    
+    resonance[lane] = laneResonance;
+    laneActive[lane] = true;
+}
+
+void FilterBank::beginBlock()
+{
+    for (int lane = 0; lane < laneStride; ++lane)
+        laneActive[lane] = false;
+}
+
+void FilterBank::process(int numSamples)
+{
+    for (int group = 0; group < getNumGroups(); ++group)
+        processGroup(group, numSamples);
+}
+
+void FilterBank::processGroup(int group, int numSamples)
+{
+    const int firstLane = group * lanesPerGroup;
+    const int width = kernels->vectorWidth;
+    
+    // Interleave the staged lanes of every vector that has an active lane. Idle lanes
+    // sharing a vector with active ones still get processed, so they get silence and a
+    // zero coefficient, which holds their state where it is. Vectors with no active
+    // lane are skipped by the kernel and can be left alone.
+    for (int vector = firstLane; vector < firstLane + lanesPerGroup; vector += width)
+    {
+        bool vectorActive = false;
+        
+        for (int lane = vector; lane < vector + width; ++lane)
+            vectorActive = vectorActive || laneActive[lane];
+        
+        if (!vectorActive)
+            continue;
+        
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* sampleRow = samples + i * laneStride;
+            float* coefficientRow = coefficients + i * laneStride;
+            
+            for (int lane = vector; lane < vector + width; ++lane)
+            {
+                const bool active = laneActive[lane];
+                sampleRow[lane] = active ? inputStaging[lane * stagingStride + i] : 0.0f;
+                coefficientRow[lane] = active ? coefficientStaging[lane * stagingStride + i] : 0.0f;
+            }
+        }
+    }
+    
+    kernels->processFilterBank(samples + firstLane, coefficients + firstLane, resonance + firstLane,
+                               state + firstLane, laneActive + firstLane, lanesPerGroup, laneStride,
+                               numSamples, static_cast<int>(mode));
+}
+
+void FilterBank::addToOutput(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    // Summing in lane order keeps the mix independent of which thread rendered what
+    bool anyActive = false;
+    juce::FloatVectorOperations::clear(mixBuffer, numSamples);
+    
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        if (!laneActive[lane])
+            continue;
+        
+        anyActive = true;
+        
+        for (int i = 0; i < numSamples; ++i)
+            mixBuffer[i] += samples[i * laneStride + lane];
+    }
+    
+    if (!anyActive)
+        return;
+    
+    for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
+        kernels->mixToOutput(outputBuffer.getWritePointer(channel, startSample), mixBuffer, numSamples);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "DSPKernels.h"
+
+// Filters for all voices, stored interleaved ([sample][voice]) so one vector
+// instruction advances 4-16 voices' filters per sample. A single filter is a serial
+// recurrence and can't be vectorised over time, but neighbouring voices are
+// independent.
+//
+// Each block, voices write their unfiltered signal and per-sample coefficients into
+// their own contiguous staging rows, so voices rendering on different threads never
+// share a cache line. process() interleaves the staged lanes and filters them, one
+// group of lanesPerGroup lanes at a time; groups can run on different threads too.
+// addToOutput() then mixes every active lane in lane order.
+class FilterBank
+{
+public:
+    enum Mode
+    {
+        Lowpass = 0,
+        Bandpass,
+        Highpass,
+        Notch,
+        Ladder
+    };
+    
+    void prepare(int numVoices, int maxBlockSize);
+    void setKernels(const DSPKernels& newKernels) { kernels = &newKernels; }
+    
+    // Switching to or from Ladder clears every filter's state; the SVF modes share theirs
+    void setMode(Mode newMode);
+    
+    int getMaxBlockSize() const { return blockSize; }
+    
+    //==============================================================================
+    // Voice side, each voice only touches its own lane
+    void resetLane(int lane);
+    void writeLane(int lane, const float* input, const float* coefficients, float resonance, int numSamples);
+    
+    //==============================================================================
+    // Engine side
+    
+    // One cache line of every interleaved row, so groups can be processed in parallel
+    static constexpr int lanesPerGroup = DSPKernels::maxVectorWidth;
+    
+    int getNumGroups() const { return laneStride / lanesPerGroup; }
+    
+    void beginBlock();
+    void process(int numSamples); // all groups, in order
+    void processGroup(int group, int numSamples);
+    void addToOutput(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples);
+    
+private:
+    const DSPKernels* kernels = getScalarKernels();
+    Mode mode = Lowpass;
+    
+    int numLanes = 0;
+    int laneStride = 0;
+    int blockSize = 0;
+    int stagingStride = 0; // blockSize rounded up to whole cache lines
+    
+    // Cache-line aligned views into the storage blocks below
+    float* inputStaging = nullptr;       // numLanes rows of stagingStride
+    float* coefficientStaging = nullptr; // numLanes rows of stagingStride
+    float* samples = nullptr;            // blockSize rows of laneStride
+    float* coefficients = nullptr;       // blockSize rows of laneStride
+    float* state = nullptr;              // DSPKernels::filterStateRows rows of laneStride
+    
+    juce::HeapBlock<float> inputStagingStorage, coefficientStagingStorage, samplesStorage, coefficientsStorage, stateStorage;
+    juce::HeapBlock<float> resonance;    // one per lane
+    juce::HeapBlock<bool> laneActive;
+    juce::HeapBlock<float> mixBuffer;
+};
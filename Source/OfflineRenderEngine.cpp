@@ -0,0 +1,165 @@
+#include "OfflineRenderEngine.h"
+
+OfflineRenderEngine::~OfflineRenderEngine()
+{
+    // The pool outlives this instance, so make sure it has let go of our jobs
+    if (sharedPool != nullptr)
+        for (auto* job : helperJobs)
+            (*sharedPool)->pool.waitForJobToFinish(job, -1);
+}
+
+void OfflineRenderEngine::prepare(int samplesPerBlock, int numChannels, int numVoices)
+{
+    // One job per pool thread at most; the pool itself is only created on first use
+    while (helperJobs.size() < juce::SystemStats::getNumCpus() - 1)
+        helperJobs.add(new HelperJob(*this));
+    
+    maxBlockSize = samplesPerBlock;
+    
+    // Linear-phase FIR with the latency rounded to whole samples, so a bounce only
+    // differs from playback by a delay the host compensates for
+    oversampling = std::make_unique<juce::dsp::Oversampling<float>>(
+        static_cast<size_t>(numChannels), static_cast<size_t>(oversamplingOrder),
+        juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true, true);
+    oversampling->initProcessing(static_cast<size_t>(samplesPerBlock));
+    
+    channelPointers.allocate(static_cast<size_t>(numChannels), true);
+    oversampledMidi.ensureSize(4096);
+    
+    activeVoices.ensureStorageAllocated(numVoices);
+}
+
+int OfflineRenderEngine::getLatencyInSamples() const
+{
+    return oversampling != nullptr ? juce::roundToInt(oversampling->getLatencyInSamples()) : 0;
+}
+
+void OfflineRenderEngine::reset()
+{
+    if (oversampling != nullptr)
+        oversampling->reset();
+}
+
+void OfflineRenderEngine::render(SynthEngine& synth, juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages)
+{
+    jassert(oversampling != nullptr);
+    
+    if (sharedPool == nullptr)
+        sharedPool = std::make_unique<juce::SharedResourcePointer<SharedThreadPool>>();
+    
+    const int numChannels = buffer.getNumChannels();
+    
+    // Hosts may bounce with blocks larger than announced, so work in prepared-size slices
+    for (int sliceStart = 0; sliceStart < buffer.getNumSamples(); sliceStart += maxBlockSize)
+    {
+        const int sliceLength = juce::jmin(maxBlockSize, buffer.getNumSamples() - sliceStart);
+        
+        juce::dsp::AudioBlock<float> block(buffer);
+        auto slice = block.getSubBlock(static_cast<size_t>(sliceStart), static_cast<size_t>(sliceLength));
+        slice.clear();
+        
+        // Upsampling silence only gives us the oversampled buffer to render into
+        auto oversampledBlock = oversampling->processSamplesUp(slice);
+        oversampledBlock.clear();
+        
+        for (int channel = 0; channel < numChannels; ++channel)
+            channelPointers[channel] = oversampledBlock.getChannelPointer(static_cast<size_t>(channel));
+        
+        juce::AudioBuffer<float> oversampledBuffer(channelPointers.get(), numChannels,
+                                                   static_cast<int>(oversampledBlock.getNumSamples()));
+        
+        oversampledMidi.clear();
+        
+        for (const auto metadata : midiMessages)
+            if (metadata.samplePosition >= sliceStart && metadata.samplePosition < sliceStart + sliceLength)
+                oversampledMidi.addEvent(metadata.getMessage(), (metadata.samplePosition - sliceStart) * oversamplingFactor);
+        
+        synth.renderNextBlock(oversampledBuffer, oversampledMidi, 0, oversampledBuffer.getNumSamples());
+        
+        oversampling->processSamplesDown(slice);
+    }
+}
+
+void OfflineRenderEngine::renderVoices(const juce::OwnedArray<juce::SynthesiserVoice>& voicesToRender,
+                                       juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    activeVoices.clearQuick();
+    
+    for (auto* voice : voicesToRender)
+        if (voice->isVoiceActive())
+            activeVoices.add(voice);
+    
+    currentStage = Stage::Voices;
+    currentOutput = &outputAudio;
+    currentStartSample = startSample;
+    currentNumSamples = numSamples;
+    
+    runInParallel(activeVoices.size(), numSamples);
+}
+
+void OfflineRenderEngine::processFilterBank(FilterBank& bank, int numSamples)
+{
+    currentStage = Stage::FilterGroups;
+    currentBank = &bank;
+    currentNumSamples = numSamples;
+    
+    runInParallel(bank.getNumGroups(), FilterBank::lanesPerGroup * numSamples);
+}
+
+void OfflineRenderEngine::runInParallel(int numItems, int samplesPerItem)
+{
+    auto& pool = (*sharedPool)->pool;
+    
+    // Synthesiser splits blocks at every MIDI event, and for short sub-blocks waking the
+    // pool costs more than it saves, so only bring in helpers with enough work each
+    const int worthwhileHelpers = numItems * samplesPerItem / minSamplesPerHelper;
+    const int numHelpers = juce::jmin(numItems - 1, worthwhileHelpers, pool.getNumThreads(), helperJobs.size());
+    
+    numWorkItems = numItems;
+    nextItem = 0;
+    
+    if (numHelpers > 0)
+    {
+        helpersFinished.reset();
+        runningHelpers = numHelpers;
+        
+        for (int i = 0; i < numHelpers; ++i)
+        {
+            auto* job = helperJobs.getUnchecked(i);
+            
+            // A job signals before the pool has released it, so it may not be free yet
+            if (pool.contains(job))
+                pool.waitForJobToFinish(job, -1);
+            
+            pool.addJob(job, false);
+        }
+    }
+    
+    // The calling thread takes items from the same list as the helpers
+    for (int next = nextItem++; next < numItems; next = nextItem++)
+        renderItem(next);
+    
+    if (numHelpers > 0)
+        helpersFinished.wait();
+}
+
+juce::ThreadPoolJob::JobStatus OfflineRenderEngine::HelperJob::runJob()
+{
+    juce::ScopedNoDenormals noDenormals;
+    
+    for (int next = owner.nextItem++; next < owner.numWorkItems; next = owner.nextItem++)
+        owner.renderItem(next);
+    
+    if (--owner.runningHelpers == 0)
+        owner.helpersFinished.signal();
+    
+    return jobHasFinished;
+}
+
+void OfflineRenderEngine::renderItem(int index)
+{
+    if (currentStage == Stage::Voices)
+        activeVoices.getUnchecked(index)->renderNextBlock(*currentOutput, currentStartSample, currentNumSamples);
+    else
+        currentBank->processGroup(index, currentNumSamples);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include "SynthEngine.h"
+
+// Used instead of the real-time path while the host is bouncing (isNonRealtime()).
+// Deadlines don't apply there, so the synth runs oversampled and the active voices,
+// then the filter bank's lane groups, are processed in parallel. Each voice only writes
+// its own FilterBank lane and the bank mixes them in lane order, which keeps the output
+// bit-identical between runs.
+//
+// The worker threads come from one pool shared by every instance in the process,
+// created on the first offline render, so sessions that never bounce don't pay for them.
+class OfflineRenderEngine : public SynthEngine::VoiceRenderer
+{
+public:
+    static constexpr int oversamplingOrder = 2; // 4x
+    static constexpr int oversamplingFactor = 1 << oversamplingOrder;
+    
+    // Voice-samples of work each helper thread needs before it's worth waking one
+    static constexpr int minSamplesPerHelper = 2048;
+    
+    OfflineRenderEngine() = default;
+    ~OfflineRenderEngine() override;
+    
+    // Allocates the oversampler and helper jobs. Call from prepareToPlay.
+    void prepare(int samplesPerBlock, int numChannels, int numVoices);
+    
+    // Whole-sample latency of the linear-phase oversampler. The real-time path is
+    // delayed by the same amount so the plugin reports one latency in both modes.
+    int getLatencyInSamples() const;
+    
+    // Clears the oversampling filters, called when switching into offline mode
+    void reset();
+    
+    // Renders one host block through the oversampled synth
+    void render(SynthEngine& synth, juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiMessages);
+    
+    void renderVoices(const juce::OwnedArray<juce::SynthesiserVoice>& voicesToRender,
+                      juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+    void processFilterBank(FilterBank& bank, int numSamples) override;
+    
+private:
+    struct SharedThreadPool
+    {
+        juce::ThreadPool pool { juce::jmax(1, juce::SystemStats::getNumCpus() - 1) };
+    };
+    
+    // Reused every sub-block, so queuing work doesn't allocate
+    class HelperJob : public juce::ThreadPoolJob
+    {
+    public:
+        explicit HelperJob(OfflineRenderEngine& engine) : juce::ThreadPoolJob("Offline render"), owner(engine) {}
+        JobStatus runJob() override;
+        
+    private:
+        OfflineRenderEngine& owner;
+    };
+    
+    // Renders items [0, numItems) on the calling thread plus as many helpers as the
+    // amount of work justifies, and returns once all of them are done
+    void runInParallel(int numItems, int samplesPerItem);
+    void renderItem(int index);
+    
+    std::unique_ptr<juce::SharedResourcePointer<SharedThreadPool>> sharedPool;
+    juce::OwnedArray<HelperJob> helperJobs;
+    std::unique_ptr<juce::dsp::Oversampling<float>> oversampling;
+    
+    int maxBlockSize = 0;
+    juce::HeapBlock<float*> channelPointers;
+    juce::MidiBuffer oversampledMidi;
+    
+    // Work list for the current sub-block: the active voices, then the filter groups
+    enum class Stage { Voices, FilterGroups };
+    Stage currentStage = Stage::Voices;
+    juce::Array<juce::SynthesiserVoice*> activeVoices;
+    juce::AudioBuffer<float>* currentOutput = nullptr;
+    FilterBank* currentBank = nullptr;
+    int currentStartSample = 0;
+    int currentNumSamples = 0;
+    int numWorkItems = 0;
+    std::atomic<int> nextItem { 0 };
+    std::atomic<int> runningHelpers { 0 };
+    juce::WaitableEvent helpersFinished;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderEngine)
+};
@@ -9,16 +9,55 @@ JuceSynthAudioProcessorEditor::JuceSynthAudioProcessorEditor(JuceSynthAudioProce
     
     // Setup oscillator section
     setupKnobAndLabel(waveformKnob, waveformLabel, "WAVEFORM");
-    waveformKnob->setRange(0, 4, 1);
+    waveformKnob->setRange(0, 5, 1);
     waveformKnob->setTextValueSuffix("");
     waveformKnob->textFromValueFunction = [](double value) {
-        const char* names[] = {"Sine", "Saw", "Square", "Triangle", "Noise"};
+        const char* names[] = {"Sine", "Saw", "Square", "Triangle", "Noise", "Sample"};
         return juce::String(names[static_cast<int>(value)]);
     };
     
+    // Sample instrument loader for the Sample waveform
+    loadSamplesButton = std::make_unique<juce::TextButton>("LOAD SAMPLES");
+    loadSamplesButton->setColour(juce::TextButton::buttonColourId, juce::Colour(0xff505050));
+    loadSamplesButton->setColour(juce::TextButton::textColourOffId, juce::Colours::white);
+    loadSamplesButton->onClick = [this] { chooseSampleFolder(); };
+    addAndMakeVisible(*loadSamplesButton);
+    
+    sampleNameLabel = std::make_unique<juce::Label>();
+    sampleNameLabel->setText(processorRef.getSampleInstrumentName(), juce::dontSendNotification);
+    sampleNameLabel->setJustificationType(juce::Justification::centred);
+    sampleNameLabel->setFont(juce::Font("Arial", 11.0f, juce::Font::plain));
+    sampleNameLabel->setColour(juce::Label::textColourId, juce::Colour(0xffff6600));
+    addAndMakeVisible(*sampleNameLabel);
+    
+    underrunLabel = std::make_unique<juce::Label>();
+    underrunLabel->setJustificationType(juce::Justification::centred);
+    underrunLabel->setFont(juce::Font("Arial", 11.0f, juce::Font::plain));
+    underrunLabel->setColour(juce::Label::textColourId, juce::Colour(0xffff6600));
+    addAndMakeVisible(*underrunLabel);
+    
+    // Load readout in the title bar
+    loadLabel = std::make_unique<juce::Label>();
+    loadLabel->setJustificationType(juce::Justification::centredRight);
+    loadLabel->setFont(juce::Font("Arial", 12.0f, juce::Font::bold));
+    loadLabel->setColour(juce::Label::textColourId, juce::Colours::white);
+    addAndMakeVisible(*loadLabel);
+    
+    // Active DSP kernel variant, so benchmarks can tell which one actually ran
+    instructionSetLabel = std::make_unique<juce::Label>();
+    instructionSetLabel->setJustificationType(juce::Justification::centredRight);
+    instructionSetLabel->setFont(juce::Font("Arial", 11.0f, juce::Font::plain));
+    addAndMakeVisible(*instructionSetLabel);
+    
     // Setup filter section
     setupKnobAndLabel(filterCutoffKnob, filterCutoffLabel, "CUTOFF");
     setupKnobAndLabel(filterResonanceKnob, filterResonanceLabel, "RESONANCE");
+    setupKnobAndLabel(filterModeKnob, filterModeLabel, "MODE");
+    filterModeKnob->setRange(0, 4, 1);
+    filterModeKnob->textFromValueFunction = [](double value) {
+        const char* names[] = {"Lowpass", "Bandpass", "Highpass", "Notch", "Ladder"};
+        return juce::String(names[static_cast<int>(value)]);
+    };
     
     // Setup LFO section
     setupKnobAndLabel(lfoRateKnob, lfoRateLabel, "LFO RATE");
@@ -35,16 +74,21 @@ JuceSynthAudioProcessorEditor::JuceSynthAudioProcessorEditor(JuceSynthAudioProce
     waveformAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(params, "waveform", *waveformKnob);
     filterCutoffAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(params, "filterCutoff", *filterCutoffKnob);
     filterResonanceAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(params, "filterResonance", *filterResonanceKnob);
+    filterModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(params, "filterMode", *filterModeKnob);
     lfoRateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(params, "lfoRate", *lfoRateKnob);
     lfoAmountAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(params, "lfoAmount", *lfoAmountKnob);
     attackAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(params, "attack", *attackKnob);
     decayAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(params, "decay", *decayKnob);
     sustainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(params, "sustain", *sustainKnob);
     releaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(params, "release", *releaseKnob);
+    
+    timerCallback();
+    startTimerHz(10);
 }
 
 JuceSynthAudioProcessorEditor::~JuceSynthAudioProcessorEditor()
 {
+    stopTimer();
 }
 
 void JuceSynthAudioProcessorEditor::paint(juce::Graphics& g)
@@ -94,10 +138,17 @@ void JuceSynthAudioProcessorEditor::resized()
     const int knobSize = 70;
     const int labelHeight = 20;
     
+    loadLabel->setBounds(getWidth() - 200, 20, 180, labelHeight);
+    instructionSetLabel->setBounds(getWidth() - 200, 38, 180, 16);
+    
     // Oscillator section
     waveformKnob->setBounds(55, 130, knobSize, knobSize);
     waveformLabel->setBounds(40, 200, 100, labelHeight);
     
+    loadSamplesButton->setBounds(35, 250, 110, 24);
+    sampleNameLabel->setBounds(30, 280, 120, labelHeight);
+    underrunLabel->setBounds(30, 300, 120, labelHeight);
+    
     // Filter section  
     filterCutoffKnob->setBounds(210, 130, knobSize, knobSize);
     filterCutoffLabel->setBounds(195, 200, 100, labelHeight);
@@ -105,6 +156,9 @@ void JuceSynthAudioProcessorEditor::resized()
     filterResonanceKnob->setBounds(300, 130, knobSize, knobSize);
     filterResonanceLabel->setBounds(285, 200, 100, labelHeight);
     
+    filterModeKnob->setBounds(255, 240, knobSize, knobSize);
+    filterModeLabel->setBounds(240, 310, 100, labelHeight);
+    
     // LFO section
     lfoRateKnob->setBounds(440, 130, knobSize, knobSize);
     lfoRateLabel->setBounds(425, 200, 100, labelHeight);
@@ -141,4 +195,46 @@ void JuceSynthAudioProcessorEditor::setupKnobAndLabel(std::unique_ptr<SynthKnob>
     label->setFont(juce::Font("Arial", 12.0f, juce::Font::bold));
     label->setColour(juce::Label::textColourId, juce::Colours::white);
     addAndMakeVisible(*label);
+}
+
+void JuceSynthAudioProcessorEditor::chooseSampleFolder()
+{
+    sampleFolderChooser = std::make_unique<juce::FileChooser>("Choose a folder of samples");
+    
+    sampleFolderChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectDirectories,
+                                     [this](const juce::FileChooser& chooser)
+    {
+        const auto folder = chooser.getResult();
+        
+        if (folder == juce::File())
+            return;
+        
+        const auto result = processorRef.loadSampleInstrument(folder);
+        
+        sampleNameLabel->setText(result.wasOk() ? processorRef.getSampleInstrumentName() : result.getErrorMessage(),
+                                 juce::dontSendNotification);
+    });
+}
+
+void JuceSynthAudioProcessorEditor::timerCallback()
+{
+    const auto& governor = processorRef.getQualityGovernor();
+    const int level = governor.getLevel();
+    
+    const int maxQuality = QualityGovernor::numLevels - 1;
+    
+    loadLabel->setText("LOAD " + juce::String(juce::roundToInt(governor.getLoad() * 100.0f)) + "%"
+                       + "  QUALITY " + juce::String(maxQuality - level) + "/" + juce::String(maxQuality),
+                       juce::dontSendNotification);
+    loadLabel->setColour(juce::Label::textColourId, level > 0 ? juce::Colour(0xffff6600) : juce::Colours::white);
+    
+    const bool forcedUnavailable = processorRef.isForcedInstructionSetUnavailable();
+    instructionSetLabel->setText(juce::String("DSP ") + processorRef.getActiveInstructionSetName()
+                                 + (forcedUnavailable ? " (FORCED N/A)" : ""),
+                                 juce::dontSendNotification);
+    instructionSetLabel->setColour(juce::Label::textColourId, forcedUnavailable ? juce::Colour(0xffff6600) : juce::Colours::white);
+    
+    const int underruns = processorRef.getSampleUnderrunCount();
+    underrunLabel->setText(underruns > 0 ? "DISK DROPOUTS " + juce::String(underruns) : juce::String(),
+                           juce::dontSendNotification);
 }
\ No newline at end of file
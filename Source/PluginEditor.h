@@ -61,7 +61,8 @@ private:
 };
 
 //==============================================================================
-class JuceSynthAudioProcessorEditor : public juce::AudioProcessorEditor
+class JuceSynthAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                      private juce::Timer
 {
 public:
     JuceSynthAudioProcessorEditor(JuceSynthAudioProcessor&);
@@ -77,6 +78,7 @@ private:
     std::unique_ptr<SynthKnob> waveformKnob;
     std::unique_ptr<SynthKnob> filterCutoffKnob;
     std::unique_ptr<SynthKnob> filterResonanceKnob;
+    std::unique_ptr<SynthKnob> filterModeKnob;
     std::unique_ptr<SynthKnob> attackKnob;
     std::unique_ptr<SynthKnob> decayKnob;
     std::unique_ptr<SynthKnob> sustainKnob;
@@ -88,6 +90,7 @@ private:
     std::unique_ptr<juce::Label> waveformLabel;
     std::unique_ptr<juce::Label> filterCutoffLabel;
     std::unique_ptr<juce::Label> filterResonanceLabel;
+    std::unique_ptr<juce::Label> filterModeLabel;
     std::unique_ptr<juce::Label> attackLabel;
     std::unique_ptr<juce::Label> decayLabel;
     std::unique_ptr<juce::Label> sustainLabel;
@@ -99,6 +102,7 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> waveformAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterCutoffAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterResonanceAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> filterModeAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> attackAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> decayAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> sustainAttachment;
@@ -106,9 +110,21 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> lfoRateAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> lfoAmountAttachment;
     
+    // Sample instrument loading
+    std::unique_ptr<juce::TextButton> loadSamplesButton;
+    std::unique_ptr<juce::Label> sampleNameLabel;
+    std::unique_ptr<juce::Label> underrunLabel; // disk streaming dropouts, empty while there are none
+    std::unique_ptr<juce::FileChooser> sampleFolderChooser;
+    
+    // Render load and quality level readout
+    std::unique_ptr<juce::Label> loadLabel;
+    std::unique_ptr<juce::Label> instructionSetLabel;
+    
     void setupKnobAndLabel(std::unique_ptr<SynthKnob>& knob, 
                           std::unique_ptr<juce::Label>& label,
                           const juce::String& labelText);
+    void chooseSampleFolder();
+    void timerCallback() override;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(JuceSynthAudioProcessorEditor)
 };
\ No newline at end of file
@@ -7,11 +7,13 @@ JuceSynthAudioProcessor::JuceSynthAudioProcessor()
       parameters(*this, nullptr, "PARAMETERS",
       {
           std::make_unique<juce::AudioParameterChoice>("waveform", "Waveform", 
-              juce::StringArray{"Sine", "Saw", "Square", "Triangle", "Noise"}, 1),
+              juce::StringArray{"Sine", "Saw", "Square", "Triangle", "Noise", "Sample"}, 1),
           std::make_unique<juce::AudioParameterFloat>("filterCutoff", "Filter Cutoff",
               juce::NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.3f), 8000.0f),
           std::make_unique<juce::AudioParameterFloat>("filterResonance", "Filter Resonance",
               juce::NormalisableRange<float>(0.1f, 2.0f, 0.01f), 0.7f),
+          std::make_unique<juce::AudioParameterChoice>("filterMode", "Filter Mode",
+              juce::StringArray{"Lowpass", "Bandpass", "Highpass", "Notch", "Ladder"}, 0),
           std::make_unique<juce::AudioParameterFloat>("attack", "Attack",
               juce::NormalisableRange<float>(0.001f, 5.0f, 0.001f, 0.3f), 0.1f),
           std::make_unique<juce::AudioParameterFloat>("decay", "Decay",
@@ -30,6 +32,7 @@ JuceSynthAudioProcessor::JuceSynthAudioProcessor()
     waveformParam = parameters.getRawParameterValue("waveform");
     filterCutoffParam = parameters.getRawParameterValue("filterCutoff");
     filterResonanceParam = parameters.getRawParameterValue("filterResonance");
+    filterModeParam = parameters.getRawParameterValue("filterMode");
     attackParam = parameters.getRawParameterValue("attack");
     decayParam = parameters.getRawParameterValue("decay");
     sustainParam = parameters.getRawParameterValue("sustain");
@@ -37,10 +40,17 @@ JuceSynthAudioProcessor::JuceSynthAudioProcessor()
     lfoRateParam = parameters.getRawParameterValue("lfoRate");
     lfoAmountParam = parameters.getRawParameterValue("lfoAmount");
     
+    forcedInstructionSet = juce::SystemStats::getEnvironmentVariable("JUCESYNTH_FORCE_ISA", {});
+    
+    formatManager.registerBasicFormats();
+    
     // Initialize the synthesizer with voices
     for (int i = 0; i < numVoices; ++i)
     {
-        synth.addVoice(new SynthVoice());
+        auto* voice = new SynthVoice();
+        voice->setSampleStreamer(sampleStreamer, i);
+        voice->setFilterBank(synth.getFilterBank(), i);
+        synth.addVoice(voice);
     }
     
     // Add our sound
@@ -105,15 +115,40 @@ void JuceSynthAudioProcessor::changeProgramName(int index, const juce::String& n
 
 void JuceSynthAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    synth.setCurrentPlaybackSampleRate(sampleRate);
+    hostSampleRate = sampleRate;
+    hostBlockSize = samplesPerBlock;
+    
+    // Pick the DSP kernel variant once, based on CPUID or the forced override
+    kernels = &DSPKernels::select(forcedInstructionSet.toRawUTF8());
+    
+    InstructionSet forced;
+    forcedInstructionSetUnavailable = forcedInstructionSet.isNotEmpty()
+                                      && !(DSPKernels::parseName(forcedInstructionSet.toRawUTF8(), forced)
+                                           && kernels->instructionSet == forced);
+    
+    synth.getFilterBank().prepare(synth.getNumVoices(), samplesPerBlock);
+    synth.getFilterBank().setKernels(*kernels);
     
     for (int i = 0; i < synth.getNumVoices(); ++i)
     {
         if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
         {
-            voice->prepareToPlay(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+            voice->setKernels(*kernels);
         }
     }
+    
+    offlineEngine.prepare(samplesPerBlock, getTotalNumOutputChannels(), synth.getNumVoices());
+    
+    // Report the oversampler's latency in both modes, so bounces line up with playback
+    const int latency = offlineEngine.getLatencyInSamples();
+    setLatencySamples(latency);
+    
+    realtimeDelay.setMaximumDelayInSamples(juce::jmax(1, latency));
+    realtimeDelay.prepare({ sampleRate, static_cast<juce::uint32>(samplesPerBlock),
+                            static_cast<juce::uint32>(getTotalNumOutputChannels()) });
+    realtimeDelay.setDelay(static_cast<float>(latency));
+    qualityGovernor.prepare(sampleRate);
+    setRenderMode(isNonRealtime());
 }
 
 void JuceSynthAudioProcessor::releaseResources()
@@ -134,6 +169,7 @@ bool JuceSynthAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts)
 void JuceSynthAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    const auto startTicks = juce::Time::getHighResolutionTicks();
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -141,11 +177,31 @@ void JuceSynthAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
+    // Switch engines when the host starts or stops bouncing
+    if (isNonRealtime() != offlineMode)
+        setRenderMode(isNonRealtime());
+
     // Update voice parameters
     updateVoiceParameters();
 
     // Process the synthesizer with MIDI messages and generate audio
+    if (offlineMode)
+    {
+        offlineEngine.render(synth, buffer, midiMessages);
+        return;
+    }
+    
     synth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+    
+    juce::dsp::AudioBlock<float> block(buffer);
+    realtimeDelay.process(juce::dsp::ProcessContextReplacing<float>(block));
+    
+    // Measure this block against its deadline; any quality change applies from the next one
+    const auto elapsedTicks = juce::Time::getHighResolutionTicks() - startTicks;
+    qualityGovernor.update(juce::Time::highResolutionTicksToSeconds(elapsedTicks), buffer.getNumSamples());
+    
+    if (qualityGovernor.getLevel() != appliedQualityLevel)
+        applyQualityLevel(qualityGovernor.getLevel());
 }
 
 bool JuceSynthAudioProcessor::hasEditor() const
@@ -172,6 +228,40 @@ void JuceSynthAudioProcessor::setStateInformation(const void* data, int sizeInBy
     if (xmlState.get() != nullptr)
         if (xmlState->hasTagName(parameters.state.getType()))
             parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
+    
+    // Reload the sample instrument the state refers to
+    const juce::String sampleFolder = parameters.state.getProperty("sampleFolder");
+    const auto* instrument = sampleStreamer.getInstrument();
+    
+    if (sampleFolder.isNotEmpty() && (instrument == nullptr || instrument->getFolder() != juce::File(sampleFolder)))
+        loadSampleInstrument(juce::File(sampleFolder));
+}
+
+juce::Result JuceSynthAudioProcessor::loadSampleInstrument(const juce::File& folder)
+{
+    // Reading the heads happens here, off the audio thread
+    auto instrument = std::make_unique<SampleInstrument>();
+    const auto result = instrument->loadFromFolder(folder, formatManager);
+    
+    if (result.failed())
+        return result;
+    
+    // Voices may hold pointers into the old instrument, so swap while suspended
+    suspendProcessing(true);
+    synth.allNotesOff(0, false);
+    sampleStreamer.setInstrument(std::move(instrument));
+    suspendProcessing(false);
+    
+    parameters.state.setProperty("sampleFolder", folder.getFullPathName(), nullptr);
+    return result;
+}
+
+juce::String JuceSynthAudioProcessor::getSampleInstrumentName() const
+{
+    if (const auto* instrument = sampleStreamer.getInstrument())
+        return instrument->getName();
+    
+    return {};
 }
 
 void JuceSynthAudioProcessor::updateVoiceParameters()
@@ -179,14 +269,19 @@ void JuceSynthAudioProcessor::updateVoiceParameters()
     const auto waveform = static_cast<SynthVoice::WaveformType>(static_cast<int>(waveformParam->load()));
     const auto cutoff = filterCutoffParam->load();
     const auto resonance = filterResonanceParam->load();
+    const auto filterMode = static_cast<FilterBank::Mode>(static_cast<int>(filterModeParam->load()));
     const auto lfoRate = lfoRateParam->load();
     const auto lfoAmount = lfoAmountParam->load();
     
+    const auto quality = QualityGovernor::getSettings(juce::jmax(0, appliedQualityLevel), synth.getNumVoices());
+    
     juce::ADSR::Parameters adsrParams;
     adsrParams.attack = attackParam->load();
     adsrParams.decay = decayParam->load();
     adsrParams.sustain = sustainParam->load();
-    adsrParams.release = releaseParam->load();
+    adsrParams.release = releaseParam->load() * quality.releaseScale;
+    
+    synth.getFilterBank().setMode(filterMode);
     
     for (int i = 0; i < synth.getNumVoices(); ++i)
     {
@@ -202,6 +297,62 @@ void JuceSynthAudioProcessor::updateVoiceParameters()
     }
 }
 
+void JuceSynthAudioProcessor::setRenderMode(bool offline)
+{
+    // Offline, the synth runs oversampled and parameter changes are ramped per sample
+    // across each host block instead of jumping at block boundaries.
+    offlineMode = offline;
+    
+    const double renderSampleRate = offline ? hostSampleRate * OfflineRenderEngine::oversamplingFactor
+                                            : hostSampleRate;
+    const double parameterRampSeconds = offline ? hostBlockSize / hostSampleRate : 0.0;
+    
+    synth.setCurrentPlaybackSampleRate(renderSampleRate);
+    synth.setVoiceRenderer(offline ? &offlineEngine : nullptr);
+    
+    for (int i = 0; i < synth.getNumVoices(); ++i)
+    {
+        if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
+        {
+            voice->prepareToPlay(renderSampleRate, hostBlockSize, getTotalNumOutputChannels());
+            voice->setParameterSmoothing(parameterRampSeconds);
+            
+            // Fixed noise seeds make repeated bounces bit-identical
+            if (offline)
+                voice->setNoiseSeed(i + 1);
+        }
+    }
+    
+    // Offline, sample voices wait for the disk instead of dropping out
+    for (int i = 0; i < sampleStreamer.getNumStreams(); ++i)
+        sampleStreamer.getStream(i).setBlockingReads(offline);
+    
+    if (offline)
+        offlineEngine.reset();
+    else
+        realtimeDelay.reset();
+    
+    // Bounces always run at full quality
+    qualityGovernor.reset();
+    applyQualityLevel(0);
+}
+
+void JuceSynthAudioProcessor::applyQualityLevel(int level)
+{
+    appliedQualityLevel = level;
+    
+    const auto settings = QualityGovernor::getSettings(level, synth.getNumVoices());
+    synth.setMaxPolyphony(settings.maxPolyphony);
+    
+    for (int i = 0; i < synth.getNumVoices(); ++i)
+    {
+        if (auto voice = dynamic_cast<SynthVoice*>(synth.getVoice(i)))
+        {
+            voice->setModulationInterval(settings.modulationInterval);
+        }
+    }
+}
+
 // This creates new instances of the plugin
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
@@ -4,6 +4,9 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include "SynthVoice.h"
 #include "SynthSound.h"
+#include "SynthEngine.h"
+#include "OfflineRenderEngine.h"
+#include "QualityGovernor.h"
 
 class JuceSynthAudioProcessor : public juce::AudioProcessor
 {
@@ -39,18 +42,58 @@ public:
     
     // Parameter access
     juce::AudioProcessorValueTreeState& getValueTreeState() { return parameters; }
+    
+    // DSP kernel dispatch. The forced instruction set ("scalar", "sse2", "avx2" or
+    // "avx512", empty for CPU detection) defaults to the JUCESYNTH_FORCE_ISA environment
+    // variable and takes effect at the next prepareToPlay.
+    void setForcedInstructionSet(const juce::String& name) { forcedInstructionSet = name; }
+    const char* getActiveInstructionSetName() const { return kernels->name; }
+    
+    // True when the forced instruction set was unknown or can't run on this CPU, so
+    // CPU detection picked the kernels instead
+    bool isForcedInstructionSetUnavailable() const { return forcedInstructionSetUnavailable; }
+    
+    // Sample oscillator. Loads a folder of samples (see SampleInstrument) and stores
+    // its path in the plugin state; call from the message thread.
+    juce::Result loadSampleInstrument(const juce::File& folder);
+    juce::String getSampleInstrumentName() const;
+    int getSampleUnderrunCount() const { return sampleStreamer.getUnderrunCount(); }
+    
+    // Real-time load and quality readout for the editor
+    const QualityGovernor& getQualityGovernor() const { return qualityGovernor; }
 
 private:
-    juce::Synthesiser synth;
+    SynthEngine synth;
     const int numVoices = 8; // Number of simultaneous notes
     
+    // Sample playback, one stream per voice
+    juce::AudioFormatManager formatManager;
+    SampleStreamer sampleStreamer { numVoices };
+    
+    // Offline (bounce) rendering
+    OfflineRenderEngine offlineEngine;
+    bool offlineMode = false;
+    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::None> realtimeDelay; // matches the oversampler latency
+    double hostSampleRate = 44100.0;
+    int hostBlockSize = 512;
+    
+    // Real-time quality scaling
+    QualityGovernor qualityGovernor;
+    int appliedQualityLevel = -1;
+    
     // Parameter management
     juce::AudioProcessorValueTreeState parameters;
     
+    // DSP kernels
+    juce::String forcedInstructionSet;
+    std::atomic<bool> forcedInstructionSetUnavailable { false };
+    const DSPKernels* kernels = getScalarKernels();
+    
     // Parameter pointers
     std::atomic<float>* waveformParam = nullptr;
     std::atomic<float>* filterCutoffParam = nullptr;
     std::atomic<float>* filterResonanceParam = nullptr;
+    std::atomic<float>* filterModeParam = nullptr;
     std::atomic<float>* attackParam = nullptr;
     std::atomic<float>* decayParam = nullptr;
     std::atomic<float>* sustainParam = nullptr;
@@ -59,6 +102,8 @@ private:
     std::atomic<float>* lfoAmountParam = nullptr;
     
     void updateVoiceParameters();
+    void setRenderMode(bool offline);
+    void applyQualityLevel(int level);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(JuceSynthAudioProcessor)
 };
\ No newline at end of file
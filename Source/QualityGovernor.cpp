@@ -0,0 +1,71 @@
+#include "QualityGovernor.h"
+
+QualityGovernor::Settings QualityGovernor::getSettings(int levelToUse, int numVoices)
+{
+    switch (levelToUse)
+    {
+        case 0:  return { 1, numVoices, 1.0f };
+        case 1:  return { 8, numVoices, 1.0f };
+        case 2:  return { 16, juce::jmax(1, numVoices * 3 / 4), 0.75f };
+        default: return { 32, juce::jmax(1, numVoices / 2), 0.5f };
+    }
+}
+
+void QualityGovernor::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    reset();
+}
+
+void QualityGovernor::reset()
+{
+    load = 0.0f;
+    level = 0;
+    secondsSinceChange = 0.0;
+    secondsUnderStepUp = 0.0;
+    restartEstimate = true;
+}
+
+void QualityGovernor::update(double renderSeconds, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    const double blockSeconds = numSamples / sampleRate;
+    const auto blockLoad = static_cast<float>(renderSeconds / blockSeconds);
+    auto smoothed = load.load(std::memory_order_relaxed);
+
+    if (restartEstimate)
+    {
+        smoothed = blockLoad;
+        restartEstimate = false;
+    }
+    else
+    {
+        const double timeConstant = blockLoad > smoothed ? riseTimeSeconds : fallTimeSeconds;
+        smoothed += (blockLoad - smoothed) * static_cast<float>(1.0 - std::exp(-blockSeconds / timeConstant));
+    }
+
+    load.store(smoothed, std::memory_order_relaxed);
+
+    auto currentLevel = level.load(std::memory_order_relaxed);
+    secondsSinceChange += blockSeconds;
+    secondsUnderStepUp = smoothed < stepUpLoad ? secondsUnderStepUp + blockSeconds : 0.0;
+
+    // Give each change a moment to show up in the measurements before the next one
+    if (smoothed > stepDownLoad && currentLevel < numLevels - 1 && secondsSinceChange >= stepDownHoldSeconds)
+        changeLevel(currentLevel + 1);
+    else if (currentLevel > 0 && secondsUnderStepUp >= stepUpHoldSeconds)
+        changeLevel(currentLevel - 1);
+}
+
+void QualityGovernor::changeLevel(int newLevel)
+{
+    level.store(newLevel, std::memory_order_relaxed);
+    secondsSinceChange = 0.0;
+    secondsUnderStepUp = 0.0;
+
+    // The caller applies the new level before the next block, which is the first
+    // measurement that reflects it
+    restartEstimate = true;
+}
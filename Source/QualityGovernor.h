@@ -0,0 +1,54 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// Watches how long each processBlock takes compared to the buffer duration and
+// trades fidelity for headroom before the host drops out. The load estimate rises
+// quickly and falls slowly; the quality level steps down one notch when it crosses
+// stepDownLoad, and only steps back up after it has stayed under stepUpLoad for a
+// while, so it doesn't flap around a threshold. After every change the estimate
+// restarts from the next block's load, so a step that fixed the overload isn't
+// followed by another one while the old readings decay. All time constants are in
+// seconds, so the behaviour doesn't depend on the buffer size.
+class QualityGovernor
+{
+public:
+    struct Settings
+    {
+        int modulationInterval; // samples between filter coefficient updates
+        int maxPolyphony;       // voices beyond this are stolen
+        float releaseScale;     // multiplier for the release time
+    };
+
+    static constexpr int numLevels = 4;
+
+    // Level 0 is full quality
+    static Settings getSettings(int level, int numVoices);
+
+    void prepare(double sampleRate);
+    void reset();
+
+    // Call once per block with the time it took to render numSamples
+    void update(double renderSeconds, int numSamples);
+
+    int getLevel() const { return level.load(std::memory_order_relaxed); }
+    float getLoad() const { return load.load(std::memory_order_relaxed); }
+
+private:
+    void changeLevel(int newLevel);
+
+    static constexpr float stepDownLoad = 0.75f;
+    static constexpr float stepUpLoad = 0.45f;
+    static constexpr double riseTimeSeconds = 0.015;
+    static constexpr double fallTimeSeconds = 0.2;
+    static constexpr double stepDownHoldSeconds = 0.05;
+    static constexpr double stepUpHoldSeconds = 1.0;
+
+    double sampleRate = 44100.0;
+    double secondsSinceChange = 0.0;
+    double secondsUnderStepUp = 0.0;
+    bool restartEstimate = true;
+
+    std::atomic<float> load { 0.0f };
+    std::atomic<int> level { 0 };
+};
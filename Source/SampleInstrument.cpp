@@ -0,0 +1,129 @@
+#include "SampleInstrument.h"
+
+juce::Result SampleInstrument::loadFromFolder(const juce::File& folderToLoad, juce::AudioFormatManager& formatManager)
+{
+    if (!folderToLoad.isDirectory())
+        return juce::Result::fail("Not a folder: " + folderToLoad.getFullPathName());
+
+    zones.clear();
+    folder = folderToLoad;
+    name = folderToLoad.getFileName();
+
+    for (const auto& entry : juce::RangedDirectoryIterator(folderToLoad, false, formatManager.getWildcardForAllFormats()))
+    {
+        const auto file = entry.getFile();
+        const int rootNote = parseRootNote(file.getFileNameWithoutExtension());
+
+        if (rootNote < 0)
+            continue;
+
+        auto reader = createReader(file, formatManager);
+
+        if (reader == nullptr || reader->lengthInSamples <= 0)
+            continue;
+
+        auto zone = std::make_unique<SampleZone>();
+        zone->file = file;
+        zone->rootNote = rootNote;
+        zone->sampleRate = reader->sampleRate;
+        zone->lengthInFrames = reader->lengthInSamples;
+
+        // Read the attack head now, downmixed to mono
+        const int headLength = static_cast<int>(juce::jmin(zone->lengthInFrames,
+                                                           static_cast<juce::int64>(std::ceil(reader->sampleRate * headSeconds))));
+        juce::AudioBuffer<float> stereoHead(2, headLength);
+        reader->read(&stereoHead, 0, headLength, 0, true, true);
+
+        zone->head.setSize(1, headLength);
+        zone->head.copyFrom(0, 0, stereoHead, 0, 0, headLength, 0.5f);
+        zone->head.addFrom(0, 0, stereoHead, 1, 0, headLength, 0.5f);
+
+        zone->reader = std::move(reader);
+        zones.add(zone.release());
+    }
+
+    if (zones.isEmpty())
+        return juce::Result::fail("No samples with a root note in their name found in " + folderToLoad.getFullPathName());
+
+    // Each zone covers the keys up to halfway to its neighbours
+    std::sort(zones.begin(), zones.end(), [](const SampleZone* a, const SampleZone* b) { return a->rootNote < b->rootNote; });
+
+    for (int i = 0; i < zones.size(); ++i)
+    {
+        auto* zone = zones.getUnchecked(i);
+        zone->lowNote = (i == 0) ? 0 : zones.getUnchecked(i - 1)->highNote + 1;
+        zone->highNote = (i == zones.size() - 1) ? 127 : (zone->rootNote + zones.getUnchecked(i + 1)->rootNote) / 2;
+    }
+
+    return juce::Result::ok();
+}
+
+const SampleZone* SampleInstrument::findZone(int midiNoteNumber) const
+{
+    for (auto* zone : zones)
+        if (midiNoteNumber >= zone->lowNote && midiNoteNumber <= zone->highNote)
+            return zone;
+
+    return nullptr;
+}
+
+int SampleInstrument::parseRootNote(const juce::String& fileNameWithoutExtension)
+{
+    const auto tokens = juce::StringArray::fromTokens(fileNameWithoutExtension, " _-.", "");
+
+    for (int i = tokens.size(); --i >= 0;)
+    {
+        const auto token = tokens[i].trim();
+
+        if (token.isEmpty())
+            continue;
+
+        if (token.containsOnly("0123456789"))
+        {
+            const int note = token.getIntValue();
+
+            if (note >= 0 && note <= 127)
+                return note;
+
+            continue;
+        }
+
+        // Note name: letter, optional accidental, octave (C4 = 60)
+        static const int semitones[] = { 9, 11, 0, 2, 4, 5, 7 }; // A B C D E F G
+        const auto letter = juce::CharacterFunctions::toUpperCase(token[0]);
+
+        if (letter < 'A' || letter > 'G')
+            continue;
+
+        int note = semitones[letter - 'A'];
+        auto octave = token.substring(1);
+
+        if (octave.startsWithChar('#'))      { ++note; octave = octave.substring(1); }
+        else if (octave.startsWithChar('b')) { --note; octave = octave.substring(1); }
+
+        if (octave.isEmpty() || !octave.containsOnly("0123456789"))
+            continue;
+
+        note += (octave.getIntValue() + 1) * 12;
+
+        if (note >= 0 && note <= 127)
+            return note;
+    }
+
+    return -1;
+}
+
+std::unique_ptr<juce::AudioFormatReader> SampleInstrument::createReader(const juce::File& file, juce::AudioFormatManager& formatManager)
+{
+    // Prefer a memory-mapped reader (WAV, AIFF) so prefetching is just page faults on
+    // the streaming thread; fall back to a normal streaming reader for other formats.
+    if (auto* format = formatManager.findFormatForFileExtension(file.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(file));
+
+        if (mapped != nullptr && mapped->mapEntireFile())
+            return mapped;
+    }
+
+    return std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(file));
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+// One sample file mapped to a range of keys. Only the first headSeconds of audio is
+// kept in RAM (mono); the rest is read on demand by the SampleStreamer thread.
+struct SampleZone
+{
+    juce::File file;
+    int rootNote = 60;
+    int lowNote = 0;
+    int highNote = 127;
+
+    double sampleRate = 44100.0;
+    juce::int64 lengthInFrames = 0;
+
+    juce::AudioBuffer<float> head;
+    int getHeadLength() const { return head.getNumSamples(); }
+
+    // Memory-mapped where the format supports it. Only the prefetch thread reads from
+    // this after loading, so it needs no locking.
+    std::unique_ptr<juce::AudioFormatReader> reader;
+};
+
+// A multisampled instrument loaded from a folder of audio files. The root note of each
+// file is taken from its name, either as a MIDI note number ("Piano_060.wav") or a
+// note name with C4 = 60 ("Piano C4.wav", "Strings_F#3.aif").
+class SampleInstrument
+{
+public:
+    static constexpr double headSeconds = 0.5;
+
+    juce::Result loadFromFolder(const juce::File& folder, juce::AudioFormatManager& formatManager);
+
+    const SampleZone* findZone(int midiNoteNumber) const;
+
+    const juce::String& getName() const { return name; }
+    const juce::File& getFolder() const { return folder; }
+    int getNumZones() const { return zones.size(); }
+    const SampleZone& getZone(int index) const { return *zones.getUnchecked(index); }
+
+    // Parses the root note from a file name, returns -1 if there isn't one
+    static int parseRootNote(const juce::String& fileNameWithoutExtension);
+
+private:
+    std::unique_ptr<juce::AudioFormatReader> createReader(const juce::File& file, juce::AudioFormatManager& formatManager);
+
+    juce::String name;
+    juce::File folder;
+    juce::OwnedArray<SampleZone> zones;
+};
@@ -0,0 +1,267 @@
+#include "SampleStreamer.h"
+
+SampleStream::SampleStream(juce::Thread& streamerThread)
+    : streamer(streamerThread)
+{
+    ring.allocate(ringSize, true);
+}
+
+void SampleStream::start(const SampleZone* newZone, double increment)
+{
+    zone = newZone;
+    positionIncrement = increment;
+    position = 0.0;
+    lastFetched = 0.0f;
+    recoveryGain = 1.0f;
+    framesToSkip = 0;
+
+    // Publish the zone before the generation, the streamer reads them the other way round
+    ++generation;
+    requestedZone.store(zone, std::memory_order_release);
+    requestedGeneration.store(generation, std::memory_order_release);
+    streamer.notify();
+
+    // The first frames always come from the RAM head
+    nextFrameIndex = 0;
+    frameA = fetchFrame(nextFrameIndex++);
+    frameB = fetchFrame(nextFrameIndex++);
+}
+
+void SampleStream::stop()
+{
+    if (zone == nullptr)
+        return;
+
+    zone = nullptr;
+
+    ++generation;
+    requestedZone.store(nullptr, std::memory_order_release);
+    requestedGeneration.store(generation, std::memory_order_release);
+    streamer.notify();
+}
+
+void SampleStream::render(float* dest, int numSamples)
+{
+    if (zone == nullptr)
+    {
+        juce::FloatVectorOperations::clear(dest, numSamples);
+        return;
+    }
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        dest[sample] = frameA + (frameB - frameA) * static_cast<float>(position);
+
+        position += positionIncrement;
+
+        while (position >= 1.0)
+        {
+            position -= 1.0;
+            frameA = frameB;
+            frameB = fetchFrame(nextFrameIndex++);
+        }
+    }
+}
+
+float SampleStream::fetchFrame(juce::int64 index)
+{
+    if (index >= zone->lengthInFrames)
+        return 0.0f;
+
+    if (index < zone->getHeadLength())
+        return lastFetched = zone->head.getSample(0, static_cast<int>(index));
+
+    float value = 0.0f;
+
+    if (blockingReads)
+    {
+        if (!popFrame(value))
+        {
+            streamer.notify();
+
+            while (!popFrame(value))
+                juce::Thread::yield();
+        }
+
+        return lastFetched = value;
+    }
+
+    if (popFrame(value))
+    {
+        // Ramp back up after an underrun rather than jumping straight to full level
+        if (recoveryGain < 1.0f)
+        {
+            value *= recoveryGain;
+            recoveryGain = juce::jmin(1.0f, recoveryGain + 1.0f / recoveryFadeFrames);
+        }
+
+        return lastFetched = value;
+    }
+
+    // Underrun: fade towards silence and skip this frame once the data turns up
+    if (framesToSkip++ == 0)
+        underruns.fetch_add(1, std::memory_order_relaxed);
+
+    recoveryGain *= 0.9f;
+    return lastFetched *= 0.9f;
+}
+
+bool SampleStream::popFrame(float& value)
+{
+    // The ring still belongs to an earlier request until the streamer acknowledges ours
+    if (acknowledgedGeneration.load(std::memory_order_acquire) != generation)
+        return false;
+
+    while (framesToSkip > 0)
+    {
+        const int ready = fifo.getNumReady();
+
+        if (ready == 0)
+            return false;
+
+        const int numToSkip = juce::jmin(ready, framesToSkip);
+        fifo.finishedRead(numToSkip);
+        framesToSkip -= numToSkip;
+    }
+
+    const int ready = fifo.getNumReady();
+
+    if (ready == 0)
+        return false;
+
+    // Wake the streamer once as the ring drops below the mark, not on every frame
+    if (ready == lowWaterMark)
+        streamer.notify();
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(1, start1, size1, start2, size2);
+    value = ring[size1 > 0 ? start1 : start2];
+    fifo.finishedRead(1);
+    return true;
+}
+
+bool SampleStream::service(juce::AudioBuffer<float>& readBuffer)
+{
+    const auto requested = requestedGeneration.load(std::memory_order_acquire);
+
+    if (requested != seenGeneration)
+    {
+        // The audio thread won't touch the ring until we acknowledge, so it's ours to reset
+        fifo.reset();
+        streamingZone = requestedZone.load(std::memory_order_acquire);
+        readPosition = streamingZone != nullptr ? streamingZone->getHeadLength() : 0;
+        seenGeneration = requested;
+        acknowledgedGeneration.store(requested, std::memory_order_release);
+    }
+
+    if (streamingZone == nullptr || readPosition >= streamingZone->lengthInFrames)
+        return false;
+
+    // Wait for a reasonable amount of space rather than issuing lots of tiny reads
+    const int freeSpace = fifo.getFreeSpace();
+
+    if (freeSpace < readBuffer.getNumSamples() / 4)
+        return false;
+
+    const int numToRead = static_cast<int>(juce::jmin(static_cast<juce::int64>(juce::jmin(freeSpace, readBuffer.getNumSamples())),
+                                                      streamingZone->lengthInFrames - readPosition));
+
+    streamingZone->reader->read(&readBuffer, 0, numToRead, readPosition, true, true);
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numToRead, start1, size1, start2, size2);
+
+    // Downmix to mono straight into the ring
+    const float* left = readBuffer.getReadPointer(0);
+    const float* right = readBuffer.getReadPointer(1);
+
+    juce::FloatVectorOperations::add(ring + start1, left, right, size1);
+    juce::FloatVectorOperations::multiply(ring + start1, 0.5f, size1);
+
+    if (size2 > 0)
+    {
+        juce::FloatVectorOperations::add(ring + start2, left + size1, right + size1, size2);
+        juce::FloatVectorOperations::multiply(ring + start2, 0.5f, size2);
+    }
+
+    fifo.finishedWrite(size1 + size2);
+    readPosition += size1 + size2;
+    return true;
+}
+
+void SampleStream::resetAll()
+{
+    zone = nullptr;
+    streamingZone = nullptr;
+    fifo.reset();
+    framesToSkip = 0;
+
+    ++generation;
+    seenGeneration = generation;
+    requestedZone.store(nullptr, std::memory_order_release);
+    requestedGeneration.store(generation, std::memory_order_release);
+    acknowledgedGeneration.store(generation, std::memory_order_release);
+}
+
+//==============================================================================
+SampleStreamer::SampleStreamer(int numStreams)
+    : juce::Thread("Sample prefetch")
+{
+    for (int i = 0; i < numStreams; ++i)
+        streams.add(new SampleStream(*this));
+}
+
+SampleStreamer::~SampleStreamer()
+{
+    stopThread(2000);
+}
+
+void SampleStreamer::setInstrument(std::unique_ptr<SampleInstrument> newInstrument)
+{
+    {
+        const juce::ScopedLock sl(serviceLock);
+
+        for (auto* stream : streams)
+            stream->resetAll();
+
+        std::swap(instrument, newInstrument);
+    }
+
+    // The old instrument (now in newInstrument) is released outside the lock
+    if (instrument != nullptr && !isThreadRunning())
+        startThread();
+}
+
+int SampleStreamer::getUnderrunCount() const
+{
+    int total = 0;
+
+    for (auto* stream : streams)
+        total += stream->getUnderrunCount();
+
+    return total;
+}
+
+void SampleStreamer::run()
+{
+    while (!threadShouldExit())
+    {
+        bool didWork = false;
+        bool anyStreaming = false;
+
+        {
+            const juce::ScopedLock sl(serviceLock);
+
+            for (auto* stream : streams)
+            {
+                didWork = stream->service(readBuffer) || didWork;
+                anyStreaming = anyStreaming || stream->hasMoreToRead();
+            }
+        }
+
+        // Poll while rings are draining; with nothing playing, sleep until a stream
+        // starts or stops and notifies us
+        if (!didWork)
+            wait(anyStreaming ? 2 : -1);
+    }
+}
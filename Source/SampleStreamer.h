@@ -0,0 +1,116 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "SampleInstrument.h"
+
+// Playback state for one voice. The audio thread plays the zone's RAM head straight
+// away and then continues from a ring buffer that the SampleStreamer thread keeps
+// filled, so starting a note never waits for the disk.
+//
+// Handoff is lock-free: the audio thread publishes a new request by bumping
+// requestedGeneration, and only reads the ring again once the streamer has reset it
+// and acknowledged that generation. Until then, and whenever the ring runs dry, the
+// output fades out instead of blocking; the missed frames are skipped when data
+// arrives so the voice stays in time, and the output fades back in.
+class SampleStream
+{
+public:
+    static constexpr int ringSize = 32768;
+    static constexpr int lowWaterMark = ringSize / 2;  // wake the streamer below this
+    static constexpr int recoveryFadeFrames = 256;
+
+    // streamerThread is woken whenever this stream's ring runs low
+    explicit SampleStream(juce::Thread& streamerThread);
+
+    //==============================================================================
+    // Audio thread
+
+    // increment is in source frames per output sample
+    void start(const SampleZone* zone, double increment);
+    void stop();
+    bool isActive() const { return zone != nullptr; }
+
+    // Writes numSamples of linearly interpolated mono output
+    void render(float* dest, int numSamples);
+
+    // Offline renders wait for the streamer instead of underrunning
+    void setBlockingReads(bool shouldBlock) { blockingReads = shouldBlock; }
+
+    // Number of times playback has run out of streamed data
+    int getUnderrunCount() const { return underruns.load(std::memory_order_relaxed); }
+
+    //==============================================================================
+    // Streamer thread. Returns true if any frames were read.
+    bool service(juce::AudioBuffer<float>& readBuffer);
+
+    // False once the current zone has been read to the end, or when idle
+    bool hasMoreToRead() const { return streamingZone != nullptr && readPosition < streamingZone->lengthInFrames; }
+
+    // Drops everything, called while processing is suspended
+    void resetAll();
+
+private:
+    float fetchFrame(juce::int64 index);
+    bool popFrame(float& value);
+
+    // Shared
+    juce::Thread& streamer;
+    juce::AbstractFifo fifo { ringSize };
+    juce::HeapBlock<float> ring;
+    std::atomic<const SampleZone*> requestedZone { nullptr };
+    std::atomic<juce::uint32> requestedGeneration { 0 };
+    std::atomic<juce::uint32> acknowledgedGeneration { 0 };
+    std::atomic<int> underruns { 0 };
+
+    // Audio thread
+    const SampleZone* zone = nullptr;
+    juce::uint32 generation = 0;
+    double position = 0.0; // fraction between frameA and frameB
+    double positionIncrement = 1.0;
+    float frameA = 0.0f, frameB = 0.0f, lastFetched = 0.0f;
+    float recoveryGain = 1.0f;
+    juce::int64 nextFrameIndex = 0;
+    int framesToSkip = 0;
+    bool blockingReads = false;
+
+    // Streamer thread
+    const SampleZone* streamingZone = nullptr;
+    juce::uint32 seenGeneration = 0;
+    juce::int64 readPosition = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleStream)
+};
+
+//==============================================================================
+// Owns the loaded instrument, one SampleStream per voice, and the background thread
+// that prefetches the streamed part of each playing sample.
+class SampleStreamer : private juce::Thread
+{
+public:
+    explicit SampleStreamer(int numStreams);
+    ~SampleStreamer() override;
+
+    // Swaps in a new instrument (or nullptr). The caller must make sure the audio
+    // thread isn't running, e.g. with AudioProcessor::suspendProcessing().
+    void setInstrument(std::unique_ptr<SampleInstrument> newInstrument);
+
+    // Audio thread
+    const SampleInstrument* getInstrument() const { return instrument.get(); }
+    SampleStream& getStream(int index) { return *streams.getUnchecked(index); }
+    int getNumStreams() const { return streams.size(); }
+
+    // Underruns across all streams since the plugin was created, safe from any thread
+    int getUnderrunCount() const;
+
+private:
+    void run() override;
+
+    static constexpr int readChunkSize = 4096;
+
+    std::unique_ptr<SampleInstrument> instrument;
+    juce::OwnedArray<SampleStream> streams;
+    juce::AudioBuffer<float> readBuffer { 2, readChunkSize };
+    juce::CriticalSection serviceLock; // held by the streamer thread while it reads
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleStreamer)
+};
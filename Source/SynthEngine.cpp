@@ -0,0 +1,73 @@
+#include "SynthEngine.h"
+
+void SynthEngine::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    while (numSamples > 0)
+    {
+        const int chunk = juce::jmin(numSamples, filterBank.getMaxBlockSize());
+        
+        if (chunk <= 0)
+            return;
+        
+        // Voices fill their filter bank lanes...
+        filterBank.beginBlock();
+        
+        if (voiceRenderer != nullptr)
+            voiceRenderer->renderVoices(voices, outputAudio, startSample, chunk);
+        else
+            juce::Synthesiser::renderVoices(outputAudio, startSample, chunk);
+        
+        // ...then all of them are filtered and mixed at once
+        if (voiceRenderer != nullptr)
+            voiceRenderer->processFilterBank(filterBank, chunk);
+        else
+            filterBank.process(chunk);
+        
+        filterBank.addToOutput(outputAudio, startSample, chunk);
+        
+        startSample += chunk;
+        numSamples -= chunk;
+    }
+}
+
+juce::SynthesiserVoice* SynthEngine::findFreeVoice(juce::SynthesiserSound* soundToPlay, int midiChannel,
+                                                   int midiNoteNumber, bool stealIfNoneAvailable) const
+{
+    if (maxPolyphony < voices.size())
+    {
+        int numActive = 0;
+        
+        for (auto* voice : voices)
+            if (voice->isVoiceActive())
+                ++numActive;
+        
+        // Synthesiser::findVoiceToSteal assumes every voice is active and would often
+        // hand back an idle one here, so the cap has to pick among active voices itself
+        if (numActive >= maxPolyphony)
+            return stealIfNoneAvailable ? findActiveVoiceToSteal(soundToPlay) : nullptr;
+    }
+    
+    return juce::Synthesiser::findFreeVoice(soundToPlay, midiChannel, midiNoteNumber, stealIfNoneAvailable);
+}
+
+juce::SynthesiserVoice* SynthEngine::findActiveVoiceToSteal(juce::SynthesiserSound* soundToPlay) const
+{
+    // The oldest voice that is already releasing, otherwise the oldest active one
+    juce::SynthesiserVoice* oldestReleased = nullptr;
+    juce::SynthesiserVoice* oldest = nullptr;
+    
+    for (auto* voice : voices)
+    {
+        if (!voice->isVoiceActive() || !voice->canPlaySound(soundToPlay))
+            continue;
+        
+        if (voice->isPlayingButReleased()
+            && (oldestReleased == nullptr || voice->wasStartedBefore(*oldestReleased)))
+            oldestReleased = voice;
+        
+        if (oldest == nullptr || voice->wasStartedBefore(*oldest))
+            oldest = voice;
+    }
+    
+    return oldestReleased != nullptr ? oldestReleased : oldest;
+}
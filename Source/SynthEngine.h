@@ -0,0 +1,45 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "FilterBank.h"
+
+// juce::Synthesiser whose voices render into a shared FilterBank lane each instead of
+// straight into the output; the bank then filters all voices together and mixes them.
+// The voice and filter stages are pluggable so the offline engine can spread them over
+// worker threads, and there's an adjustable polyphony cap used by the quality governor.
+class SynthEngine : public juce::Synthesiser
+{
+public:
+    class VoiceRenderer
+    {
+    public:
+        virtual ~VoiceRenderer() = default;
+        
+        // Must call renderNextBlock on every voice before returning
+        virtual void renderVoices(const juce::OwnedArray<juce::SynthesiserVoice>& voicesToRender,
+                                  juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) = 0;
+        
+        // Must process every group of the bank before returning
+        virtual void processFilterBank(FilterBank& bank, int numSamples) { bank.process(numSamples); }
+    };
+    
+    // Pass nullptr to go back to the serial voice loop
+    void setVoiceRenderer(VoiceRenderer* renderer) { voiceRenderer = renderer; }
+    
+    // New notes steal a voice once this many are active
+    void setMaxPolyphony(int maxVoices) { maxPolyphony = maxVoices; }
+    
+    FilterBank& getFilterBank() { return filterBank; }
+    
+protected:
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+    juce::SynthesiserVoice* findFreeVoice(juce::SynthesiserSound* soundToPlay, int midiChannel,
+                                          int midiNoteNumber, bool stealIfNoneAvailable) const override;
+    
+private:
+    juce::SynthesiserVoice* findActiveVoiceToSteal(juce::SynthesiserSound* soundToPlay) const;
+    
+    FilterBank filterBank;
+    VoiceRenderer* voiceRenderer = nullptr;
+    int maxPolyphony = std::numeric_limits<int>::max();
+};
@@ -3,7 +3,7 @@
 
 SynthVoice::SynthVoice()
     : level(0.0), frequency(0.0), phase(0.0), sampleRate(44100.0), isPlaying(false),
-      currentWaveform(Saw), filterCutoff(8000.0f), filterResonance(0.7f), baseCutoff(8000.0f),
+      currentWaveform(Saw), filterResonance(0.7f), baseCutoff(8000.0f),
       lfoRate(2.0f), lfoAmount(0.0f), lfoPhase(0.0)
 {
     // Set default ADSR parameters
@@ -13,9 +13,6 @@ SynthVoice::SynthVoice()
     adsrParams.release = 0.8f;
     
     adsr.setParameters(adsrParams);
-    
-    // Initialize filter
-    filter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
 }
 
 bool SynthVoice::canPlaySound(juce::SynthesiserSound* sound)
@@ -29,8 +26,18 @@ void SynthVoice::startNote(int midiNoteNumber, float velocity, juce::Synthesiser
     level = velocity * 0.15;
     phase = 0.0;
     lfoPhase = 0.0; // Reset LFO phase on new note
+    currentNote = midiNoteNumber;
     isPlaying = true;
     
+    // Start from a clean filter, a stolen voice may leave ringing state behind
+    if (filterBank != nullptr)
+        filterBank->resetLane(filterLane);
+    
+    if (currentWaveform == Sample)
+        startSamplePlayback();
+    else
+        stopSamplePlayback();
+    
     adsr.noteOn();
 }
 
@@ -44,6 +51,7 @@ void SynthVoice::stopNote(float velocity, bool allowTailOff)
     {
         clearCurrentNote();
         adsr.reset();
+        stopSamplePlayback();
         isPlaying = false;
     }
 }
@@ -62,94 +70,116 @@ void SynthVoice::prepareToPlay(double sr, int samplesPerBlock, int)
 {
     sampleRate = sr;
     adsr.setSampleRate(sr);
+    baseCutoff.reset(sr, parameterRampSeconds);
     
-    // Prepare filter
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sr;
-    spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
-    spec.numChannels = 1;
-    
-    filter.prepare(spec);
-    updateFilter();
+    // Scratch space for the block kernels
+    scratchBuffer.setSize(3, samplesPerBlock);
 }
 
-void SynthVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+void SynthVoice::renderNextBlock(juce::AudioBuffer<float>&, int, int numSamples)
 {
-    if (!isPlaying)
+    if (!isPlaying || filterBank == nullptr)
         return;
     
     if (!adsr.isActive())
     {
         clearCurrentNote();
+        stopSamplePlayback();
         isPlaying = false;
         return;
     }
     
-    const double phaseIncrement = 2.0 * juce::MathConstants<double>::pi * frequency / sampleRate;
-    const double lfoPhaseIncrement = 2.0 * juce::MathConstants<double>::pi * lfoRate / sampleRate;
+    const double lfoPhaseIncrement = lfoRate / sampleRate;
+    
+    float* oscillator = scratchBuffer.getWritePointer(0);
+    float* envelope = scratchBuffer.getWritePointer(1);
+    float* cutoff = scratchBuffer.getWritePointer(2);
+    
+    // SynthEngine never asks for more than the filter bank's block size, which is
+    // also what the scratch buffer was prepared with
+    jassert(numSamples <= scratchBuffer.getNumSamples());
+    numSamples = juce::jmin(numSamples, scratchBuffer.getNumSamples());
+    
+    // Calculate LFO and apply it to the (possibly ramping) filter cutoff
+    const float cutoffStart = baseCutoff.getCurrentValue();
+    const float cutoffStep = (baseCutoff.skip(numSamples) - cutoffStart) / static_cast<float>(numSamples);
+    
+    kernels->fillOscillator(cutoff, numSamples, lfoPhase, lfoPhaseIncrement, Sine);
+    kernels->modulateCutoff(cutoff, cutoff, cutoffStart, cutoffStep, lfoAmount, numSamples);
+    kernels->computeFilterCoefficients(cutoff, numSamples, static_cast<float>(sampleRate), modulationInterval);
+    
+    generateWaveform(oscillator, numSamples);
     
     for (int sample = 0; sample < numSamples; ++sample)
-    {
-        // Calculate LFO value
-        const float lfoValue = static_cast<float>(std::sin(lfoPhase));
-        
-        // Apply LFO to filter cutoff
-        const float modulatedCutoff = baseCutoff + (lfoValue * lfoAmount * baseCutoff * 0.5f);
-        filter.setCutoffFrequency(juce::jlimit(20.0f, 20000.0f, modulatedCutoff));
-        
-        const float waveformSample = generateWaveform();
-        const float envelopedSample = waveformSample * level * adsr.getNextSample();
-        
-        // Apply filter
-        const float filteredSample = filter.processSample(0, envelopedSample);
-        
-        for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
-        {
-            outputBuffer.addSample(channel, startSample + sample, filteredSample);
-        }
-        
-        phase += phaseIncrement;
-        if (phase >= 2.0 * juce::MathConstants<double>::pi)
-            phase -= 2.0 * juce::MathConstants<double>::pi;
-            
-        lfoPhase += lfoPhaseIncrement;
-        if (lfoPhase >= 2.0 * juce::MathConstants<double>::pi)
-            lfoPhase -= 2.0 * juce::MathConstants<double>::pi;
-    }
+        envelope[sample] = adsr.getNextSample();
+    
+    kernels->applyEnvelope(oscillator, envelope, static_cast<float>(level), numSamples);
+    
+    // Filtering and mixing happen in the filter bank, across all voices
+    filterBank->writeLane(filterLane, oscillator, cutoff, filterResonance, numSamples);
+}
+
+void SynthVoice::setParameterSmoothing(double rampSeconds)
+{
+    parameterRampSeconds = rampSeconds;
+    baseCutoff.reset(sampleRate, rampSeconds);
 }
 
-float SynthVoice::generateWaveform()
+void SynthVoice::setSampleStreamer(SampleStreamer& streamer, int streamIndex)
 {
-    switch (currentWaveform)
+    sampleStreamer = &streamer;
+    sampleStream = &streamer.getStream(streamIndex);
+}
+
+void SynthVoice::startSamplePlayback()
+{
+    if (sampleStream == nullptr)
+        return;
+    
+    const auto* instrument = sampleStreamer->getInstrument();
+    const auto* zone = instrument != nullptr ? instrument->findZone(currentNote) : nullptr;
+    
+    if (zone == nullptr)
     {
-        case Sine:
-            return static_cast<float>(std::sin(phase));
-            
-        case Saw:
-            return static_cast<float>(2.0 * (phase / (2.0 * juce::MathConstants<double>::pi)) - 1.0);
-            
-        case Square:
-            return (phase < juce::MathConstants<double>::pi) ? 1.0f : -1.0f;
-            
-        case Triangle:
-        {
-            const double normalizedPhase = phase / (2.0 * juce::MathConstants<double>::pi);
-            if (normalizedPhase < 0.5)
-                return static_cast<float>(4.0 * normalizedPhase - 1.0);
-            else
-                return static_cast<float>(3.0 - 4.0 * normalizedPhase);
-        }
-            
-        case Noise:
-            return random.nextFloat() * 2.0f - 1.0f;
-            
-        default:
-            return static_cast<float>(std::sin(phase));
+        sampleStream->stop();
+        return;
     }
+    
+    // Source frames per output sample, covering both the pitch shift and any
+    // difference between the file's sample rate and ours
+    const double pitchRatio = frequency / juce::MidiMessage::getMidiNoteInHertz(zone->rootNote);
+    sampleStream->start(zone, pitchRatio * zone->sampleRate / sampleRate);
+}
+
+void SynthVoice::stopSamplePlayback()
+{
+    if (sampleStream != nullptr)
+        sampleStream->stop();
 }
 
-void SynthVoice::updateFilter()
+void SynthVoice::generateWaveform(float* dest, int numSamples)
 {
-    filter.setCutoffFrequency(filterCutoff);
-    filter.setResonance(filterResonance);
-}
\ No newline at end of file
+    if (currentWaveform == Sample)
+    {
+        // Silent if no instrument is loaded or the waveform was switched mid-note
+        if (sampleStream != nullptr)
+            sampleStream->render(dest, numSamples);
+        else
+            juce::FloatVectorOperations::clear(dest, numSamples);
+        return;
+    }
+    
+
+    if (currentWaveform == Noise)
+    {
+        for (int sample = 0; sample < numSamples; ++sample)
+            dest[sample] = random.nextFloat() * 2.0f - 1.0f;
+        
+        // Keep the phase running so switching back to a periodic waveform is seamless
+        phase += numSamples * (frequency / sampleRate);
+        phase -= std::floor(phase);
+        return;
+    }
+    
+    kernels->fillOscillator(dest, numSamples, phase, frequency / sampleRate, currentWaveform);
+}
@@ -3,6 +3,9 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
 #include "SynthSound.h"
+#include "DSPKernels.h"
+#include "SampleStreamer.h"
+#include "FilterBank.h"
 
 class SynthVoice : public juce::SynthesiserVoice
 {
@@ -13,7 +16,8 @@ public:
         Saw,
         Square,
         Triangle,
-        Noise
+        Noise,
+        Sample
     };
     
     SynthVoice();
@@ -24,21 +28,43 @@ public:
     void controllerMoved(int controllerNumber, int newControllerValue) override;
     void pitchWheelMoved(int newPitchWheelValue) override;
     void prepareToPlay(double sampleRate, int samplesPerBlock, int outputChannels);
+    
+    // Writes the unfiltered voice into its FilterBank lane; SynthEngine then filters
+    // all voices together and mixes them into outputBuffer.
     void renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples) override;
     
+    // Lane in the engine's filter bank that this voice renders into
+    void setFilterBank(FilterBank& bank, int lane) { filterBank = &bank; filterLane = lane; }
+    
+    // DSP kernel variant chosen by the processor in prepareToPlay
+    void setKernels(const DSPKernels& newKernels) { kernels = &newKernels; }
+    
+    // Source and playback stream for the Sample oscillator
+    void setSampleStreamer(SampleStreamer& streamer, int streamIndex);
+    
     // Parameter setters for external control
     void setWaveform(WaveformType waveform) { currentWaveform = waveform; }
-    void setFilterCutoff(float cutoff) { filterCutoff = cutoff; baseCutoff = cutoff; updateFilter(); }
-    void setFilterResonance(float resonance) { filterResonance = resonance; updateFilter(); }
+    void setFilterCutoff(float cutoff) { baseCutoff.setTargetValue(cutoff); }
+    void setFilterResonance(float resonance) { filterResonance = resonance; }
     void setADSRParameters(const juce::ADSR::Parameters& params) { adsrParams = params; adsr.setParameters(adsrParams); }
     void setLFORate(float rate) { lfoRate = rate; }
     void setLFOAmount(float amount) { lfoAmount = amount; }
     
+    // Ramp time for per-sample interpolation of parameter changes (0 = jump per block)
+    void setParameterSmoothing(double rampSeconds);
+    
+    // Samples between filter coefficient updates, raised by the quality governor
+    void setModulationInterval(int numSamples) { modulationInterval = juce::jmax(1, numSamples); }
+    
+    // Reseeds the noise generator so offline renders are repeatable
+    void setNoiseSeed(juce::int64 seed) { random.setSeed(seed); }
+    
 private:
     double level;
     double frequency;
-    double phase;
+    double phase; // Normalised to [0, 1)
     double sampleRate;
+    double parameterRampSeconds = 0.0;
     
     bool isPlaying;
     
@@ -46,15 +72,16 @@ private:
     WaveformType currentWaveform;
     
     // Filter
-    float filterCutoff;
     float filterResonance;
-    float baseCutoff; // Store the base cutoff for LFO modulation
-    juce::dsp::StateVariableTPTFilter<float> filter;
+    juce::SmoothedValue<float> baseCutoff; // Base cutoff for LFO modulation, ramped when smoothing is on
+    FilterBank* filterBank = nullptr;
+    int filterLane = 0;
     
     // LFO
     float lfoRate;
     float lfoAmount;
-    double lfoPhase;
+    double lfoPhase; // Normalised to [0, 1)
+    int modulationInterval = 1;
     
     // ADSR envelope
     juce::ADSR adsr;
@@ -63,7 +90,17 @@ private:
     // Random number generator for noise
     juce::Random random;
     
+    // Sample playback
+    SampleStreamer* sampleStreamer = nullptr;
+    SampleStream* sampleStream = nullptr;
+    int currentNote = 60;
+    
+    // Block processing
+    const DSPKernels* kernels = getScalarKernels();
+    juce::AudioBuffer<float> scratchBuffer; // oscillator, envelope, LFO/cutoff
+    
     // Helper methods
-    float generateWaveform();
-    void updateFilter();
+    void generateWaveform(float* dest, int numSamples);
+    void startSamplePlayback();
+    void stopSamplePlayback();
 };
\ No newline at end of file